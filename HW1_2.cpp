@@ -6,6 +6,7 @@
 */
 #include <iostream>
 #include <cstdint>
+#include "arith.hpp"
 using namespace std;
 
 /*
@@ -52,7 +53,7 @@ uint64_t nr_safe(uint64_t n, uint64_t r) {
 
     for (uint64_t i = 1; i <= r; ++i) {
         // Multiply then divide to prevent growth
-        result = result * (n - r + i) / i;
+        result = arith::div(arith::mul(result, n - r + i), i);
     }
 
     return result;
@@ -75,7 +76,7 @@ double nr_double(uint64_t n, uint64_t r) {
     double result = 1.0;
 
     for (uint64_t i = 1; i <= r; ++i) {
-        result *= (double)(n - r + i) / (double)i;
+        result = arith::mul(result, arith::div((double)(n - r + i), (double)i));
     }
 
     return result;
@@ -5,6 +5,9 @@
     The below code is for part 3 of HW1 Group Assignment
 */
 #include <iostream>
+#include <thread>
+#include <vector>
+#include "sharded_counter.hpp"
 using namespace std;
 
 /* 
@@ -32,6 +35,30 @@ void showStaticLocal() {
          << "  (recreated every call)\n";
 }
 
+/*
+    - thread_local: static storage duration, but every thread
+    gets its own copy, so no two threads ever touch the same one
+*/
+thread_local int perThreadCalls = 0;
+
+/*
+    - a global counter that is safe to bump from many threads:
+    each thread adds to its own cache-line sized slot and read()
+    adds the slots together (see sharded_counter.hpp)
+    - a plain static int here would be a data race
+*/
+ShardedCounter requestCounter;
+
+void handleRequests(int count) {
+    for (int i = 0; i < count; ++i) {
+        perThreadCalls++;
+        requestCounter.add();
+    }
+    // each thread only ever sees its own perThreadCalls
+    // (built as one string so lines from different threads don't mix)
+    cout << "  perThreadCalls = " + to_string(perThreadCalls) + "  (this thread only)\n";
+}
+
 void showUninitializedAuto() {
     int garbage;  // NOT initialized
     cout << "Uninitialized automatic variable contains: "
@@ -53,6 +80,17 @@ int main() {
     showStaticLocal();
     showStaticLocal();
 
+    cout << "\n(THREAD-LOCAL and SHARDED COUNTERS)\n";
+    vector<thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back(handleRequests, 1000);
+    }
+    for (thread& w : workers) {
+        w.join();
+    }
+    cout << "  requestCounter = " << requestCounter.read()
+         << "  (all threads added together)\n";
+
     cout << "\n(UNINITIALIZED AUTO VARIABLE)\n";
     showUninitializedAuto();
 
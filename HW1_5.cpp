@@ -11,6 +11,13 @@ Below is the code for group 1 assignment part 5
 // This allows us to use std::cout for printing to the screen
 #include <iostream>
 
+// Fixed-width integer types (std::int32_t, std::int64_t)
+#include <cstdint>
+
+// Header-only arithmetic templates (arith::add, arith::mul, arith::div)
+// The bodies live in the header, so every call below can be inlined
+#include "arith.hpp"
+
 // This is a  GLOBAL VARIABLE demo
 
 // Declare and define a global variable
@@ -20,35 +27,6 @@ int globalVar = 100;
 
 //  function prototypes
 
-// Function prototype for adding two 32-bit integers
-// Tells the compiler this function exists later
-int add32(int a, int b);
-;
-
-// Function prototype for multiplying two 32-bit integers
-int mul32(int a, int b);
-
-// Function prototype for dividing two 32-bit integers
-int div32(int a, int b);
-
-// Function prototype for adding two 64-bit integers
-long long add64(long long a, long long b);
-
-// Function prototype for multiplying two 64-bit integers
-long long mul64(long long a, long long b);
-
-// Function prototype for dividing two 64-bit integers
-long long div64(long long a, long long b);
-
-// Function prototype for adding two double-precision values
-double addDouble(double a, double b);
-
-// Function prototype for multiplying two double-precision values
-double mulDouble(double a, double b);
-
-// Function prototype for dividing two double-precision values
-double divDouble(double a, double b);
-
 // Function prototype for displaying the global variable
 void showGlobal();
 
@@ -68,10 +46,10 @@ int main()
        ====================================== */
 
     // Declare and initialize two 32-bit integer variables
-    int a = 10, b = 3;
+    std::int32_t a = 10, b = 3;
 
     // Declare and initialize two 64-bit integer variables
-    long long x = 100000, y = 3;
+    std::int64_t x = 100000, y = 3;
 
     // Declare and initialize two double-precision variables
     double d1 = 10.5, d2 = 3.2;
@@ -79,38 +57,38 @@ int main()
     // Print label for 32-bit integer operations
     std::cout << "32-bit int:\n";
 
-    // Call add32() and print the result
-    std::cout << "Add: " << add32(a, b) << "\n";
+    // Call arith::add() and print the result
+    std::cout << "Add: " << arith::add(a, b) << "\n";
 
-    // Call mul32() and print the result
-    std::cout << "Mul: " << mul32(a, b) << "\n";
+    // Call arith::mul() and print the result
+    std::cout << "Mul: " << arith::mul(a, b) << "\n";
 
-    // Call div32() and print the result
-    std::cout << "Div: " << div32(a, b) << "\n\n";
+    // Call arith::div() and print the result
+    std::cout << "Div: " << arith::div(a, b) << "\n\n";
 
     // Print label for 64-bit integer operations
     std::cout << "64-bit int:\n";
 
-    // Call add64() and print the result
-    std::cout << "Add: " << add64(x, y) << "\n";
+    // Call arith::add() and print the result
+    std::cout << "Add: " << arith::add(x, y) << "\n";
 
-    // Call mul64() and print the result
-    std::cout << "Mul: " << mul64(x, y) << "\n";
+    // Call arith::mul() and print the result
+    std::cout << "Mul: " << arith::mul(x, y) << "\n";
 
-    // Call div64() and print the result
-    std::cout << "Div: " << div64(x, y) << "\n\n";
+    // Call arith::div() and print the result
+    std::cout << "Div: " << arith::div(x, y) << "\n\n";
 
     // Print label for double-precision operations
     std::cout << "Double:\n";
 
-    // Call addDouble() and print the result
-    std::cout << "Add: " << addDouble(d1, d2) << "\n";
+    // Call arith::add() and print the result
+    std::cout << "Add: " << arith::add(d1, d2) << "\n";
 
-    // Call mulDouble() and print the result
-    std::cout << "Mul: " << mulDouble(d1, d2) << "\n";
+    // Call arith::mul() and print the result
+    std::cout << "Mul: " << arith::mul(d1, d2) << "\n";
 
-    // Call divDouble() and print the result
-    std::cout << "Div: " << divDouble(d1, d2) << "\n\n";
+    // Call arith::div() and print the result
+    std::cout << "Div: " << arith::div(d1, d2) << "\n\n";
 
     /* ======================================
        PART 2: Global Variable
@@ -137,75 +115,6 @@ int main()
    FUNCTION DEFINITIONS
    ====================================== */
 
-// 32-bit int functions
-
-// Definition of add32()
-// Takes two integers and returns their sum
-int add32(int a, int b)
-{
-    return a + b;
-}
-
-// Definition of mul32()
-// Takes two integers and returns their product
-int mul32(int a, int b)
-{
-    return a * b;
-}
-
-// Definition of div32()
-// Takes two integers and returns their quotient
-int div32(int a, int b)
-{
-    return a / b;
-}
-
-// 64-bit int functions
-
-// Definition of add64()
-// Takes two long long values and returns their sum
-long long add64(long long a, long long b)
-{
-    return a + b;
-}
-
-// Definition of mul64()
-// Takes two long long values and returns their product
-long long mul64(long long a, long long b)
-{
-    return a * b;
-}
-
-// Definition of div64()
-// Takes two long long values and returns their quotient
-long long div64(long long a, long long b)
-{
-    return a / b;
-}
-
-// Double-precision functions
-
-// Definition of addDouble()
-// Takes two doubles and returns their sum
-double addDouble(double a, double b)
-{
-    return a + b;
-}
-
-// Definition of mulDouble()
-// Takes two doubles and returns their product
-double mulDouble(double a, double b)
-{
-    return a * b;
-}
-
-// Definition of divDouble()
-// Takes two doubles and returns their quotient
-double divDouble(double a, double b)
-{
-    return a / b;
-}
-
 // Global variable function
 
 // Definition of showGlobal()
@@ -0,0 +1,169 @@
+/*
+    O(1) weighted sampling: Walker's alias method, built with Vose's
+    algorithm.
+
+    The table has one column per category. A draw takes 64 random bits
+    (one std::mt19937_64 call or two std::mt19937 calls): the high half
+    picks a column, the low half decides between the column and its
+    alias. Weights are integers and the table is built the same way on
+    every platform, so a given generator state always yields the same
+    category, unlike std::discrete_distribution.
+
+    Weights can change after every draw. Rebuilding is O(n), so the
+    table is built over upper bounds instead (each weight plus 12.5%
+    headroom), and a draw of category i is accepted with probability
+    weight[i] / bound[i], otherwise retried; that test reuses the bits
+    left over from picking the column. set_weight() therefore only
+    records the new weight, unless it exceeds its bound or more than
+    half of all draws would be retried; only then is the table marked
+    stale, and it is rebuilt once on the next draw, however many
+    weights changed in between.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace arena {
+
+class AliasSampler {
+public:
+    AliasSampler() = default;
+    AliasSampler(std::size_t n, std::uint32_t weight) { assign(n, weight); }
+    explicit AliasSampler(const std::vector<std::uint32_t>& weights) { assign(weights); }
+
+    void assign(std::size_t n, std::uint32_t weight) {
+        entries_.assign(n, Entry{weight, 0});
+        total_weight_ = static_cast<std::uint64_t>(weight) * n;
+        stale_ = true;
+    }
+
+    void assign(const std::vector<std::uint32_t>& weights) {
+        entries_.resize(weights.size());
+        total_weight_ = 0;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            entries_[i].weight = weights[i];
+            total_weight_ += weights[i];
+        }
+        stale_ = true;
+    }
+
+    std::size_t size() const { return entries_.size(); }
+    std::uint32_t weight(std::size_t i) const { return entries_[i].weight; }
+    std::uint64_t total_weight() const { return total_weight_; }
+    std::uint64_t rebuilds() const { return rebuilds_; }
+
+    void set_weight(std::size_t i, std::uint32_t w) {
+        total_weight_ = total_weight_ - entries_[i].weight + w;
+        entries_[i].weight = w;
+        if (w > entries_[i].bound || total_weight_ * 2 < total_bound_) {
+            stale_ = true;
+        }
+    }
+
+    // Index of the drawn category. Needs at least one nonzero weight
+    // and a generator of full 32- or 64-bit values (std::mt19937 or
+    // std::mt19937_64).
+    template <typename URBG>
+    std::size_t operator()(URBG& gen) {
+        if (stale_) rebuild();
+        while (true) {
+            std::uint64_t r = random64(gen);
+            std::uint64_t scaled = (r >> 32) * columns_.size();
+            auto column = static_cast<std::size_t>(scaled >> 32);
+            Column c = columns_[column];
+            std::size_t i = static_cast<std::uint32_t>(r) < c.keep ? column : c.alias;
+            // Accept with probability weight / bound: frac / 2^32 < weight / bound.
+            std::uint64_t frac = static_cast<std::uint32_t>(scaled);
+            if (frac * entries_[i].bound < static_cast<std::uint64_t>(entries_[i].weight) << 32) {
+                return i;
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        std::uint32_t weight;
+        std::uint32_t bound; // what the table was built with, >= weight while fresh
+    };
+
+    struct Column {
+        std::uint32_t keep;  // keep the column if a 32-bit draw is below this
+        std::uint32_t alias; // a full column aliases itself
+    };
+
+    template <typename URBG>
+    static std::uint64_t random64(URBG& gen) {
+        static_assert(URBG::min() == 0, "AliasSampler needs a full-range generator");
+        if constexpr (URBG::max() == std::numeric_limits<std::uint64_t>::max()) {
+            return gen();
+        } else {
+            static_assert(URBG::max() == std::numeric_limits<std::uint32_t>::max(),
+                          "AliasSampler needs a 32- or 64-bit generator");
+            std::uint64_t high = static_cast<std::uint32_t>(gen());
+            return (high << 32) | static_cast<std::uint32_t>(gen());
+        }
+    }
+
+    void rebuild() {
+        std::size_t n = entries_.size();
+        columns_.resize(n);
+        scaled_.resize(n);
+        work_.resize(n);
+
+        total_bound_ = 0;
+        for (Entry& e : entries_) {
+            std::uint64_t b = e.weight + (static_cast<std::uint64_t>(e.weight) + 7) / 8;
+            e.bound = b > std::numeric_limits<std::uint32_t>::max()
+                          ? std::numeric_limits<std::uint32_t>::max()
+                          : static_cast<std::uint32_t>(b);
+            total_bound_ += e.bound;
+        }
+
+        // Vose: scale every bound by n so a column holds exactly
+        // total_bound_, then pair each under-full column with an
+        // over-full one that tops it up. Under-full columns are stacked
+        // from the front of work_, over-full ones from the back.
+        std::size_t small = 0;
+        std::size_t large = n;
+        for (std::size_t i = 0; i < n; ++i) {
+            scaled_[i] = static_cast<std::uint64_t>(entries_[i].bound) * n;
+            work_[scaled_[i] < total_bound_ ? small++ : --large] = static_cast<std::uint32_t>(i);
+        }
+        // Only the keep thresholds are rounded (to 32 bits); the pairing
+        // itself is exact, and IEEE doubles round the same everywhere.
+        const double to_keep = 4294967296.0 / static_cast<double>(total_bound_);
+        while (small > 0 && large < n) {
+            std::uint32_t s = work_[--small];
+            std::uint32_t l = work_[large];
+            double keep = static_cast<double>(scaled_[s]) * to_keep;
+            columns_[s] = {keep < 4294967295.0 ? static_cast<std::uint32_t>(keep) : 0xffffffffu, l};
+            scaled_[l] -= total_bound_ - scaled_[s];
+            if (scaled_[l] < total_bound_) {
+                ++large;
+                work_[small++] = l;
+            }
+        }
+        // The pairing is exact, so whatever is left is exactly full.
+        for (std::size_t k = 0; k < small; ++k) columns_[work_[k]] = {0, work_[k]};
+        for (std::size_t k = large; k < n; ++k) columns_[work_[k]] = {0, work_[k]};
+
+        stale_ = false;
+        ++rebuilds_;
+    }
+
+    std::vector<Entry> entries_;
+    std::vector<Column> columns_;
+    std::uint64_t total_weight_ = 0;
+    std::uint64_t total_bound_ = 0;
+    bool stale_ = true;
+    std::uint64_t rebuilds_ = 0;
+
+    // Rebuild scratch, kept so that a rebuild does not allocate.
+    std::vector<std::uint64_t> scaled_;
+    std::vector<std::uint32_t> work_;
+};
+
+} // namespace arena
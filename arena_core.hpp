@@ -0,0 +1,195 @@
+/*
+    Game rules shared by overflow_arena.cpp and the offline tools.
+
+    Holds the wrap/binary helpers, the GameType table and the round
+    dealer. A RoundDealer seeded with the same value and told the same
+    results deals the same rounds, which is what lets arena_replay
+    regrade a recorded session without the original process.
+*/
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "alias_sampler.hpp"
+#include "wide_int.hpp"
+
+namespace arena {
+
+template <typename T>
+std::string to_binary_string(T value) {
+    using UnsignedT = std::make_unsigned_t<T>;
+    UnsignedT bits = static_cast<UnsignedT>(value);
+    if constexpr (sizeof(UnsignedT) == 1) {
+        return std::bitset<8>(bits).to_string();
+    } else if constexpr (sizeof(UnsignedT) == 2) {
+        return std::bitset<16>(bits).to_string();
+    } else if constexpr (sizeof(UnsignedT) == 4) {
+        return std::bitset<32>(bits).to_string();
+    } else {
+        return std::bitset<64>(bits).to_string();
+    }
+}
+
+inline std::string binary_from_signed(long long value, int bits) {
+    unsigned long long mask = (bits == 64) ? std::numeric_limits<unsigned long long>::max()
+                                           : ((1ULL << bits) - 1ULL);
+    unsigned long long uvalue = static_cast<unsigned long long>(value) & mask;
+    if (bits == 8) return std::bitset<8>(uvalue).to_string();
+    if (bits == 16) return std::bitset<16>(uvalue).to_string();
+    if (bits == 32) return std::bitset<32>(uvalue).to_string();
+    return std::bitset<64>(uvalue).to_string();
+}
+
+inline long long wrap_unsigned(long long value, int bits) {
+    if (bits == 64) {
+        return static_cast<unsigned long long>(value);
+    }
+    if (bits < 1 || bits > 63) {
+        return value;
+    }
+    unsigned long long mod = (1ULL << bits);
+    unsigned long long uvalue = static_cast<unsigned long long>(value);
+    unsigned long long wrapped = uvalue % mod;
+    return static_cast<long long>(wrapped);
+}
+
+// FIXED: correct for negative inputs; avoids UB; uses safe modulo + sign conversion
+inline long long wrap_signed(long long value, int bits) {
+    if (bits < 1 || bits > 63) {
+        return value;
+    }
+
+    const unsigned long long mod = (1ULL << bits);
+
+    long long wrapped = value % static_cast<long long>(mod);
+    if (wrapped < 0) {
+        wrapped += static_cast<long long>(mod);
+    }
+
+    const long long sign_bit = 1LL << (bits - 1);
+    if (wrapped & sign_bit) {
+        wrapped -= static_cast<long long>(mod);
+    }
+    return wrapped;
+}
+
+// Game values are computed 256 bits wide, so an op on any type up to
+// 128 bits is exact before wrap_to_type() brings it back in range.
+using GameValue = wide_int<256>;
+
+struct GameType {
+    std::string name;
+    int bits;
+    bool is_signed;
+    GameValue min_value;
+    GameValue max_value;
+};
+
+inline GameType make_game_type(std::string name, int bits, bool is_signed) {
+    GameValue half = GameValue::power_of_two(bits - 1);
+    GameValue min_value = is_signed ? -half : GameValue(0);
+    GameValue max_value = (is_signed ? half : half + half) - GameValue(1);
+    return {std::move(name), bits, is_signed, min_value, max_value};
+}
+
+// New types go at the end: a log's type_index refers to this order.
+inline std::vector<GameType> make_game_types() {
+    return {
+        make_game_type("uint8_t", 8, false),
+        make_game_type("uint16_t", 16, false),
+        make_game_type("int8_t", 8, true),
+        make_game_type("int16_t", 16, true),
+        make_game_type("int32_t", 32, true),
+        make_game_type("uint32_t", 32, false),
+        make_game_type("int64_t", 64, true),
+        make_game_type("uint64_t", 64, false),
+        make_game_type("__int128", 128, true),
+    };
+}
+
+// Op choices dealt by RoundDealer: 0 = "+1", 1 = "-1", 2 = "*2".
+constexpr int kOpCount = 3;
+
+inline const char* op_name(int op_choice) {
+    static const char* const names[kOpCount] = {"+1", "-1", "*2"};
+    return names[op_choice];
+}
+
+inline GameValue apply_op(int op_choice, const GameValue& v) {
+    if (op_choice == 0) return v + GameValue(1);
+    if (op_choice == 1) return v - GameValue(1);
+    return v * GameValue(2);
+}
+
+inline GameValue start_value(const GameType& gt, bool near_max) {
+    return near_max ? gt.max_value - GameValue(1) : gt.min_value + GameValue(1);
+}
+
+inline GameValue wrap_to_type(const GameType& gt, const GameValue& wide) {
+    return gt.is_signed ? wrap_signed(wide, gt.bits) : wrap_unsigned(wide, gt.bits);
+}
+
+struct RoundDraw {
+    int type_index;
+    int op_choice;
+    bool near_max;
+};
+
+// Deals rounds in the same order the interactive arena always has:
+// type, then op, then which end of the range to start from. Types and
+// ops are weighted toward what the player gets wrong: every miss
+// raises the weight of that round's type and op, every correct answer
+// lowers it again, never below where it started.
+class RoundDealer {
+public:
+    static constexpr std::uint32_t kBaseWeight = 8;
+    static constexpr std::uint32_t kMissStep = 8;
+    static constexpr std::uint32_t kHitStep = 4;
+    static constexpr std::uint32_t kMaxWeight = 8 * kBaseWeight;
+
+    RoundDealer(std::uint32_t seed, std::size_t type_count)
+        : gen_(seed),
+          types_(type_count, kBaseWeight),
+          ops_(kOpCount, kBaseWeight) {}
+
+    RoundDraw next() {
+        RoundDraw d;
+        d.type_index = static_cast<int>(types_(gen_));
+        d.op_choice = static_cast<int>(ops_(gen_));
+        d.near_max = (gen_() >> 31) != 0; // the top bit, same on every standard library
+        return d;
+    }
+
+    // Call once per graded round, before the next deal.
+    void record(const RoundDraw& d, bool correct) {
+        adjust(types_, static_cast<std::size_t>(d.type_index), correct);
+        adjust(ops_, static_cast<std::size_t>(d.op_choice), correct);
+    }
+
+    const AliasSampler& type_weights() const { return types_; }
+    const AliasSampler& op_weights() const { return ops_; }
+
+private:
+    static void adjust(AliasSampler& sampler, std::size_t i, bool correct) {
+        std::uint32_t w = sampler.weight(i);
+        if (correct) {
+            w = w > kBaseWeight + kHitStep ? w - kHitStep : kBaseWeight;
+        } else {
+            w = w + kMissStep < kMaxWeight ? w + kMissStep : kMaxWeight;
+        }
+        sampler.set_weight(i, w);
+    }
+
+    std::mt19937 gen_;
+    AliasSampler types_;
+    AliasSampler ops_;
+};
+
+} // namespace arena
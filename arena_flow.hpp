@@ -0,0 +1,219 @@
+/*
+    C++20 coroutine plumbing for the lesson flows (needs -std=c++20).
+
+    Task<T> is a lazily started coroutine that can co_await other Tasks.
+    LineInput is where a flow waits for the player: co_await
+    in.next_line() suspends the innermost coroutine, and whoever owns the
+    input (stdin, a socket, a replay) resumes it later with feed(). The
+    Scheduler just runs ready coroutines, so one thread can interleave
+    any number of sessions, each costing one coroutine frame chain
+    instead of a thread stack.
+
+    Frames normally come from the global heap. While a FrameArenaScope
+    is alive they come from its memory resource instead, which is how
+    overflow_arena keeps a whole lesson's frames in one RoundArena.
+*/
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory_resource>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace arena {
+
+class Scheduler {
+public:
+    void schedule(std::coroutine_handle<> h) { ready_.push_back(h); }
+
+    // Resumes coroutines until every one of them is waiting or done.
+    // A vector rather than a deque: once it has grown, scheduling never
+    // allocates again.
+    void run() {
+        for (std::size_t i = 0; i < ready_.size(); ++i) {
+            ready_[i].resume();
+        }
+        ready_.clear();
+    }
+
+private:
+    std::vector<std::coroutine_handle<>> ready_;
+};
+
+namespace flow_detail {
+
+inline thread_local std::pmr::memory_resource* t_frame_resource = nullptr;
+
+struct PromiseBase {
+    // Every frame starts with the resource it came from, so it can be
+    // freed after the scope that picked that resource has ended.
+    static constexpr std::size_t kFrameHeader = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    static void* operator new(std::size_t size) {
+        std::pmr::memory_resource* r = t_frame_resource ? t_frame_resource : std::pmr::new_delete_resource();
+        void* p = r->allocate(size + kFrameHeader, kFrameHeader);
+        *static_cast<std::pmr::memory_resource**>(p) = r;
+        return static_cast<std::byte*>(p) + kFrameHeader;
+    }
+
+    static void operator delete(void* frame, std::size_t size) {
+        void* p = static_cast<std::byte*>(frame) - kFrameHeader;
+        std::pmr::memory_resource* r = *static_cast<std::pmr::memory_resource**>(p);
+        r->deallocate(p, size + kFrameHeader, kFrameHeader);
+    }
+
+    std::coroutine_handle<> continuation;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            std::coroutine_handle<> next = h.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept { std::terminate(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+    void return_value(T v) { value = std::move(v); }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    void return_void() noexcept {}
+};
+
+} // namespace flow_detail
+
+// Coroutine frames created on this thread while the scope is alive are
+// allocated from `resource`. The scope may live in a coroutine frame and
+// span suspensions, as long as nothing else on the thread starts flows
+// in the meantime. Scopes nest.
+class FrameArenaScope {
+public:
+    explicit FrameArenaScope(std::pmr::memory_resource* resource)
+        : saved_(std::exchange(flow_detail::t_frame_resource, resource)) {}
+    ~FrameArenaScope() { flow_detail::t_frame_resource = saved_; }
+
+    FrameArenaScope(const FrameArenaScope&) = delete;
+    FrameArenaScope& operator=(const FrameArenaScope&) = delete;
+
+private:
+    std::pmr::memory_resource* saved_;
+};
+
+template <typename T = void>
+class [[nodiscard]] Task {
+public:
+    struct promise_type : flow_detail::Promise<T> {
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+    };
+
+    Task(Task&& other) noexcept : h_(std::exchange(other.h_, nullptr)) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task& operator=(Task&&) = delete;
+    ~Task() {
+        if (h_) h_.destroy();
+    }
+
+    // For drivers: hand this to Scheduler::schedule() to start a top-level flow.
+    std::coroutine_handle<> handle() const { return h_; }
+    bool done() const { return h_.done(); }
+
+    // Awaiting a Task starts it and resumes the awaiter when it finishes.
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        h_.promise().continuation = awaiting;
+        return h_;
+    }
+    T await_resume() {
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*h_.promise().value);
+        }
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> h) : h_(h) {}
+
+    std::coroutine_handle<promise_type> h_;
+};
+
+// One per session. Lines passed to feed() must stay valid until the
+// flow suspends again; flows parse them right away.
+class LineInput {
+public:
+    explicit LineInput(Scheduler& scheduler) : scheduler_(&scheduler) {}
+
+    // Resumes with the next line, or std::nullopt once input is closed.
+    auto next_line() {
+        struct Awaiter {
+            LineInput* self;
+            bool await_ready() const noexcept { return self->closed_; }
+            void await_suspend(std::coroutine_handle<> h) noexcept { self->waiting_ = h; }
+            std::optional<std::string_view> await_resume() noexcept {
+                if (self->closed_) return std::nullopt;
+                return self->line_;
+            }
+        };
+        return Awaiter{this};
+    }
+
+    // The flow is finished with this session for good (e.g. input closed
+    // mid-lesson). Never resumes; the driver should destroy the flow.
+    auto hang_up() {
+        hung_up_ = true;
+        return std::suspend_always{};
+    }
+
+    bool waiting() const { return static_cast<bool>(waiting_); }
+    bool hung_up() const { return hung_up_; }
+
+    void feed(std::string_view line) {
+        line_ = line;
+        wake();
+    }
+
+    void close() {
+        closed_ = true;
+        wake();
+    }
+
+private:
+    void wake() {
+        if (waiting_) {
+            scheduler_->schedule(std::exchange(waiting_, nullptr));
+        }
+    }
+
+    Scheduler* scheduler_;
+    std::coroutine_handle<> waiting_;
+    std::string_view line_;
+    bool closed_ = false;
+    bool hung_up_ = false;
+};
+
+// What every flow gets: where to print and where to wait for input.
+struct FlowIo {
+    std::ostream& out;
+    LineInput& in;
+};
+
+} // namespace arena
@@ -0,0 +1,324 @@
+/*
+    A live leaderboard shared by every arena process on the machine.
+
+    The board is a POSIX shared-memory segment (shm_open + mmap, so it
+    shows up under /dev/shm/<name>): a one-line Header, then kCapacity
+    cache-line-sized Entry slots. A player claims a slot once with a
+    fetch_add on Header::claimed, stamps its pid in Entry::owner and is
+    the only writer of that slot from then on, so updates take no lock
+    and never share a cache line with another player; thousands of
+    processes can update at once. Once every slot has been handed out,
+    claim() scans for a slot whose owner process has exited and takes
+    it over with a CAS on the owner word, so a long-lived board keeps
+    accepting players.
+
+    Each slot is a seqlock. The writer makes the sequence odd, stores
+    the fields, then makes it even again; a reader copies the fields
+    between two reads of the sequence and retries if they differ or are
+    odd. Readers therefore never block writers and never see half an
+    update. A writer descheduled (or killed) mid-update leaves its slot
+    odd; readers spin kMaxRetries times and then leave the slot out of
+    that snapshot rather than wait, since yielding to one writer among
+    thousands of runnable ones can take whole scheduler rounds. A player
+    that takes over such a slot finishes the odd window with its own
+    fields.
+
+    Every field is a lock-free std::atomic, which is address-free, so
+    the same bytes are valid in every process that maps them. The
+    segment is zero-filled when created, and zero is a valid empty
+    board: whichever process opens it first just stamps the magic.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "arena_log.hpp"
+#include "sharded_counter.hpp"
+
+namespace arena {
+
+namespace leaderboard_format {
+
+constexpr std::uint64_t kMagic = 0x32304452424C414Full; // "OALBRD02" in memory order
+constexpr std::uint32_t kCapacity = 16384;
+constexpr std::size_t kNameWords = 4;
+constexpr std::size_t kNameBytes = kNameWords * 8;
+constexpr int kMaxRetries = 1000;
+
+struct alignas(kCacheLineSize) Header {
+    std::atomic<std::uint64_t> magic;
+    std::atomic<std::uint64_t> claimed; // may run past kCapacity
+};
+
+struct alignas(kCacheLineSize) Entry {
+    std::atomic<std::uint64_t> sequence; // 0: claimed, never published
+    std::atomic<std::uint32_t> pid;
+    std::atomic<std::uint32_t> score;
+    std::atomic<std::uint32_t> rounds;
+    std::atomic<std::uint32_t> owner; // pid of the writer; 0 until stamped
+    std::atomic<std::uint64_t> updated_ns; // CLOCK_REALTIME
+    std::atomic<std::uint64_t> name[kNameWords]; // NUL-padded
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "the segment is shared between processes");
+static_assert(sizeof(Header) == kCacheLineSize);
+static_assert(sizeof(Entry) == kCacheLineSize);
+
+constexpr std::size_t kSegmentSize = sizeof(Header) + kCapacity * sizeof(Entry);
+
+} // namespace leaderboard_format
+
+// Whether pid names a running process (EPERM: running, not ours).
+inline bool process_alive(std::uint32_t pid) {
+    return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+}
+
+struct LeaderboardRow {
+    std::uint32_t slot;
+    std::uint32_t pid;
+    std::uint32_t score;
+    std::uint32_t rounds;
+    std::uint64_t updated_ns;
+    std::string name;
+};
+
+// One player's slot; cheap to copy, but only one copy may write.
+class LeaderboardSlot {
+public:
+    LeaderboardSlot() = default;
+
+    explicit operator bool() const { return entry_ != nullptr; }
+
+    // Counts a graded round and publishes the new totals.
+    void record_round(bool correct) {
+        ++rounds_;
+        if (correct) ++score_;
+        publish();
+    }
+
+private:
+    friend class Leaderboard;
+
+    LeaderboardSlot(leaderboard_format::Entry* entry, std::string_view player)
+        : entry_(entry), pid_(static_cast<std::uint32_t>(getpid())) {
+        player = player.substr(0, leaderboard_format::kNameBytes);
+        char bytes[leaderboard_format::kNameBytes] = {};
+        std::memcpy(bytes, player.data(), player.size());
+        std::memcpy(name_, bytes, sizeof(bytes));
+        publish();
+    }
+
+    void publish() {
+        leaderboard_format::Entry& e = *entry_;
+        std::uint64_t now = realtime_ns(); // outside the odd window
+        // Already odd only in a slot taken over from a writer that died
+        // mid-update; that window is simply reused.
+        std::uint64_t odd = e.sequence.load(std::memory_order_relaxed) | 1;
+        e.sequence.store(odd, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        e.pid.store(pid_, std::memory_order_relaxed);
+        e.score.store(score_, std::memory_order_relaxed);
+        e.rounds.store(rounds_, std::memory_order_relaxed);
+        e.updated_ns.store(now, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < leaderboard_format::kNameWords; ++i) {
+            e.name[i].store(name_[i], std::memory_order_relaxed);
+        }
+        e.sequence.store(odd + 1, std::memory_order_release);
+    }
+
+    leaderboard_format::Entry* entry_ = nullptr;
+    std::uint64_t name_[leaderboard_format::kNameWords] = {};
+    std::uint32_t pid_ = 0;
+    std::uint32_t score_ = 0;
+    std::uint32_t rounds_ = 0;
+};
+
+enum class BoardStatus { ok, io_error, bad_segment };
+
+class Leaderboard {
+public:
+    Leaderboard() = default;
+    Leaderboard(const Leaderboard&) = delete;
+    Leaderboard& operator=(const Leaderboard&) = delete;
+    ~Leaderboard() { close(); }
+
+    // Opens board `name` ("arena" or "/arena"), creating it if needed.
+    // io_error leaves errno set.
+    BoardStatus open(const char* name) { return map(name, true); }
+
+    // Opens an existing board for snapshot() only.
+    BoardStatus open_read_only(const char* name) { return map(name, false); }
+
+    // Removes the board's name; processes that have it open keep it.
+    static bool remove(const char* name) { return shm_unlink(shm_name(name).c_str()) == 0; }
+
+    bool is_open() const { return header_ != nullptr; }
+
+    void close() {
+        if (header_ != nullptr) {
+            munmap(header_, leaderboard_format::kSegmentSize);
+        }
+        header_ = nullptr;
+        entries_ = nullptr;
+    }
+
+    // Claims a slot for `player` (the first 32 bytes are kept). When
+    // all kCapacity slots have been handed out, takes over one whose
+    // owner has exited (one kill(pid, 0) per slot scanned); returns an
+    // empty slot if every owner is still running.
+    LeaderboardSlot claim(std::string_view player) {
+        using namespace leaderboard_format;
+        std::uint32_t self = static_cast<std::uint32_t>(getpid());
+        std::uint64_t index = header_->claimed.fetch_add(1, std::memory_order_relaxed);
+        if (index < kCapacity) {
+            entries_[index].owner.store(self, std::memory_order_relaxed);
+            return LeaderboardSlot(&entries_[index], player);
+        }
+        for (std::uint32_t i = 0; i < kCapacity; ++i) {
+            std::uint32_t owner = entries_[i].owner.load(std::memory_order_relaxed);
+            if (owner == 0 || process_alive(owner)) continue;
+            // Losing the race means another claimer took this slot.
+            if (entries_[i].owner.compare_exchange_strong(owner, self, std::memory_order_acq_rel)) {
+                return LeaderboardSlot(&entries_[i], player);
+            }
+        }
+        return {};
+    }
+
+    std::uint64_t claimed() const {
+        return std::min<std::uint64_t>(header_->claimed.load(std::memory_order_relaxed),
+                                       leaderboard_format::kCapacity);
+    }
+
+    // A consistent copy of every published slot. Slots that stay
+    // mid-update are left out and counted in *stuck, if given.
+    std::vector<LeaderboardRow> snapshot(std::size_t* stuck = nullptr) const {
+        std::vector<LeaderboardRow> rows;
+        std::uint64_t n = claimed();
+        rows.reserve(static_cast<std::size_t>(n));
+        std::size_t stuck_slots = 0;
+        for (std::uint64_t i = 0; i < n; ++i) {
+            LeaderboardRow row;
+            switch (read_slot(static_cast<std::uint32_t>(i), row)) {
+            case ReadResult::ok:
+                rows.push_back(std::move(row));
+                break;
+            case ReadResult::stuck:
+                ++stuck_slots;
+                break;
+            case ReadResult::unpublished:
+                break;
+            }
+        }
+        if (stuck != nullptr) *stuck = stuck_slots;
+        return rows;
+    }
+
+    // The k best rows of a snapshot: most correct, then fewest rounds,
+    // then whoever got there first.
+    static std::vector<LeaderboardRow> top(std::vector<LeaderboardRow> rows, std::size_t k) {
+        auto better = [](const LeaderboardRow& a, const LeaderboardRow& b) {
+            if (a.score != b.score) return a.score > b.score;
+            if (a.rounds != b.rounds) return a.rounds < b.rounds;
+            return a.updated_ns < b.updated_ns;
+        };
+        k = std::min(k, rows.size());
+        std::partial_sort(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(k), rows.end(), better);
+        rows.resize(k);
+        return rows;
+    }
+
+private:
+    enum class ReadResult { ok, unpublished, stuck };
+
+    static std::string shm_name(const char* name) {
+        return name[0] == '/' ? std::string(name) : "/" + std::string(name);
+    }
+
+    BoardStatus map(const char* name, bool writable) {
+        using namespace leaderboard_format;
+        close();
+        std::string path = shm_name(name);
+        int fd = shm_open(path.c_str(), (writable ? O_RDWR | O_CREAT : O_RDONLY) | O_CLOEXEC, 0666);
+        if (fd < 0) {
+            return BoardStatus::io_error;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return BoardStatus::io_error;
+        }
+        // Growing from 0 to the fixed size is idempotent, so racing
+        // creators are harmless.
+        if (st.st_size == 0 && writable && ftruncate(fd, static_cast<off_t>(kSegmentSize)) == 0) {
+            st.st_size = static_cast<off_t>(kSegmentSize);
+        }
+        if (st.st_size != static_cast<off_t>(kSegmentSize)) {
+            ::close(fd);
+            return BoardStatus::bad_segment;
+        }
+        void* p = mmap(nullptr, kSegmentSize, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            return BoardStatus::io_error;
+        }
+        header_ = static_cast<Header*>(p);
+        entries_ = reinterpret_cast<Entry*>(static_cast<char*>(p) + sizeof(Header));
+
+        std::uint64_t magic = header_->magic.load(std::memory_order_acquire);
+        if (magic == 0 && writable) {
+            header_->magic.compare_exchange_strong(magic, kMagic, std::memory_order_acq_rel);
+            if (magic == 0) magic = kMagic;
+        }
+        // A board nobody has stamped yet reads as empty.
+        if (magic != kMagic && !(magic == 0 && !writable)) {
+            close();
+            return BoardStatus::bad_segment;
+        }
+        return BoardStatus::ok;
+    }
+
+    ReadResult read_slot(std::uint32_t index, LeaderboardRow& row) const {
+        const leaderboard_format::Entry& e = entries_[index];
+        for (int attempt = 0; attempt < leaderboard_format::kMaxRetries; ++attempt) {
+            std::uint64_t before = e.sequence.load(std::memory_order_acquire);
+            if (before == 0) return ReadResult::unpublished;
+            if (before & 1) continue;
+            row.pid = e.pid.load(std::memory_order_relaxed);
+            row.score = e.score.load(std::memory_order_relaxed);
+            row.rounds = e.rounds.load(std::memory_order_relaxed);
+            row.updated_ns = e.updated_ns.load(std::memory_order_relaxed);
+            std::uint64_t name[leaderboard_format::kNameWords];
+            for (std::size_t i = 0; i < leaderboard_format::kNameWords; ++i) {
+                name[i] = e.name[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (e.sequence.load(std::memory_order_relaxed) != before) continue;
+
+            const char* bytes = reinterpret_cast<const char*>(name);
+            row.name.assign(bytes, strnlen(bytes, leaderboard_format::kNameBytes));
+            row.slot = index;
+            return ReadResult::ok;
+        }
+        return ReadResult::stuck;
+    }
+
+    leaderboard_format::Header* header_ = nullptr;
+    leaderboard_format::Entry* entries_ = nullptr;
+};
+
+} // namespace arena
@@ -0,0 +1,289 @@
+/*
+    Load generator for arena_server.
+
+    Opens many sessions at once, plays a fixed number of rounds in each
+    (always guessing 0) and measures round latency: the time from
+    sending a guess to receiving the complete next "Your guess: " prompt.
+
+    With --half-close each client instead sends all R guesses at once,
+    shuts down its write side and reads until the server closes. Every
+    guess must still be answered (R + 1 prompts, counting the first);
+    sessions that come up short are reported and the exit status is 1.
+
+    Build: g++ -std=c++17 -O2 arena_loadgen.cpp -o arena_loadgen
+    Usage: arena_loadgen [--socket PATH] [--sessions N] [--rounds R] [--half-close]
+*/
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "arena_parse.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::string_view kPrompt = "Your guess: ";
+
+struct Client {
+    int fd = -1;
+    int rounds_done = 0;
+    bool started = false;  // first prompt received
+    bool quitting = false;
+    int prompts = 0;       // --half-close: prompts received so far
+    Clock::time_point sent_at;
+    std::string tail;      // last bytes received, enough to spot the prompt
+};
+
+bool send_line(int fd, std::string_view line) {
+    while (!line.empty()) {
+        ssize_t n = send(fd, line.data(), line.size(), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        line.remove_prefix(static_cast<std::size_t>(n));
+    }
+    return true;
+}
+
+// Appends to the client's tail and reports whether it now ends in a prompt.
+bool saw_prompt(Client& c, const char* data, std::size_t size) {
+    c.tail.append(data, size);
+    if (c.tail.size() > 2 * kPrompt.size()) {
+        c.tail.erase(0, c.tail.size() - kPrompt.size());
+    }
+    if (c.tail.size() >= kPrompt.size() &&
+        std::string_view(c.tail).substr(c.tail.size() - kPrompt.size()) == kPrompt) {
+        c.tail.clear();
+        return true;
+    }
+    return false;
+}
+
+// Counts the prompts in the stream, including ones split across reads.
+int count_prompts(Client& c, const char* data, std::size_t size) {
+    c.tail.append(data, size);
+    int found = 0;
+    std::size_t after = 0; // end of the last prompt found
+    for (std::size_t pos; (pos = c.tail.find(kPrompt, after)) != std::string::npos;) {
+        ++found;
+        after = pos + kPrompt.size();
+    }
+    // Only a prompt's first bytes can still complete one.
+    std::size_t keep = std::min(c.tail.size() - after, kPrompt.size() - 1);
+    c.tail.erase(0, c.tail.size() - keep);
+    return found;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    std::size_t index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+void usage() {
+    std::cerr << "usage: arena_loadgen [--socket PATH] [--sessions N] [--rounds R] [--half-close]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string socket_path = "/tmp/overflow_arena.sock";
+    int sessions = 10000;
+    int rounds = 20;
+    bool half_close = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (arg == "--sessions" && i + 1 < argc) {
+            if (arena::parse_int(argv[++i], sessions, 1, 1000000) != arena::ParseStatus::ok) {
+                usage();
+                return 1;
+            }
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            if (arena::parse_int(argv[++i], rounds, 1, 1000000) != arena::ParseStatus::ok) {
+                usage();
+                return 1;
+            }
+        } else if (arg == "--half-close") {
+            half_close = true;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "socket path too long\n";
+        return 1;
+    }
+    std::memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        perror("epoll_create1");
+        return 1;
+    }
+
+    // Connect with blocking sockets so a full listen backlog just waits
+    // for the server to catch up, then switch to non-blocking.
+    std::vector<Client> clients(static_cast<std::size_t>(sessions));
+    for (int i = 0; i < sessions; ++i) {
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            perror("socket");
+            return 1;
+        }
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            perror("connect");
+            return 1;
+        }
+        if (half_close) {
+            std::string guesses;
+            for (int r = 0; r < rounds; ++r) guesses += "0\n";
+            if (!send_line(fd, guesses) || shutdown(fd, SHUT_WR) != 0) {
+                perror("send");
+                return 1;
+            }
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        clients[static_cast<std::size_t>(i)].fd = fd;
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u32 = static_cast<std::uint32_t>(i);
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            perror("epoll_ctl");
+            return 1;
+        }
+    }
+
+    std::vector<double> latencies_us;
+    latencies_us.reserve(static_cast<std::size_t>(sessions) * static_cast<std::size_t>(rounds));
+
+    // Let the server reach every EOF with its replies backed up in the
+    // socket before reading any, as a slow client would.
+    if (half_close) usleep(100000);
+
+    int open_clients = sessions;
+    int short_sessions = 0;
+    Clock::time_point t0 = Clock::now();
+    std::vector<epoll_event> events(1024);
+    char buf[8192];
+    while (open_clients > 0) {
+        int n = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            return 1;
+        }
+        for (int e = 0; e < n; ++e) {
+            Client& c = clients[events[e].data.u32];
+            bool prompt = false;
+            bool closed = false;
+            while (true) {
+                ssize_t got = read(c.fd, buf, sizeof(buf));
+                if (got < 0) {
+                    if (errno == EINTR) continue;
+                    if (errno != EAGAIN && errno != EWOULDBLOCK) closed = true;
+                    break;
+                }
+                if (got == 0) {
+                    closed = true;
+                    break;
+                }
+                if (half_close) {
+                    c.prompts += count_prompts(c, buf, static_cast<std::size_t>(got));
+                    continue;
+                }
+                prompt = saw_prompt(c, buf, static_cast<std::size_t>(got)) || prompt;
+            }
+
+            if (closed && half_close) {
+                c.rounds_done = std::max(c.prompts - 1, 0);
+                if (c.prompts != rounds + 1) {
+                    std::cerr << "session " << events[e].data.u32 << ": " << c.rounds_done << " of " << rounds
+                              << " guesses answered\n";
+                    ++short_sessions;
+                }
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c.fd, nullptr);
+                close(c.fd);
+                --open_clients;
+                continue;
+            }
+            if (closed) {
+                if (!c.quitting) {
+                    std::cerr << "session " << events[e].data.u32 << " closed early\n";
+                }
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c.fd, nullptr);
+                close(c.fd);
+                --open_clients;
+                continue;
+            }
+            if (!prompt || c.quitting) continue;
+
+            if (c.started) {
+                auto us = std::chrono::duration<double, std::micro>(Clock::now() - c.sent_at).count();
+                latencies_us.push_back(us);
+                ++c.rounds_done;
+            }
+            c.started = true;
+
+            if (c.rounds_done == rounds) {
+                c.quitting = true;
+                send_line(c.fd, "q\n");
+            } else {
+                c.sent_at = Clock::now();
+                send_line(c.fd, "0\n");
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    close(epoll_fd);
+
+    if (half_close) {
+        std::uint64_t answered = 0;
+        for (const Client& c : clients) answered += static_cast<std::uint64_t>(c.rounds_done);
+        std::cout << "Sessions: " << sessions << "  rounds/session: " << rounds << "  (half-close)\n";
+        std::cout << "Rounds:   " << answered << " answered in " << std::fixed << std::setprecision(3) << seconds
+                  << " s, " << short_sessions << " session(s) short\n";
+        return short_sessions == 0 ? 0 : 1;
+    }
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    std::cout << "Sessions: " << sessions << "  rounds/session: " << rounds << "\n";
+    std::cout << "Rounds:   " << latencies_us.size() << " in " << std::fixed
+              << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(0) << static_cast<double>(latencies_us.size()) / seconds
+              << " rounds/s)\n";
+    std::cout << std::setprecision(1)
+              << "Latency:  p50 " << percentile(latencies_us, 0.50) << " us"
+              << "  p99 " << percentile(latencies_us, 0.99) << " us"
+              << "  max " << (latencies_us.empty() ? 0.0 : latencies_us.back()) << " us\n";
+    return 0;
+}
@@ -0,0 +1,229 @@
+/*
+    Append-only binary log of arena rounds.
+
+    File layout: a 16-byte FileHeader, then fixed-size blocks of
+    kBlockRecords rounds each. Inside a block the fields are stored as
+    columns (all type indexes, then all ops, ...), so record i of a
+    block always sits at the same offsets and a reader can scan one
+    column with SIMD without touching the others. The last block of a
+    flush may be partly filled; its count says how many slots are used.
+
+    RoundLogWriter buffers blocks and appends them with O_APPEND, so
+    several processes can share one log file. Buffered rounds go out
+    when kBufferedBlocks blocks are full, when an append finds the
+    oldest buffered round kFlushAfterNs old, and on flush() or close();
+    a partly filled block costs a little space, not correctness.
+    scan_accuracy() maps
+    nothing itself: hand it the bytes of a mapped log (see
+    arena::MappedFile) and it tallies rounds and correct answers per
+    GameType index.
+*/
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string_view>
+#include <vector>
+
+#include <emmintrin.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace arena {
+
+struct RoundRecord {
+    std::uint8_t type_index;
+    std::uint8_t op;
+    std::uint8_t correct;
+    std::int64_t start;         // values of types wider than 64 bits
+    std::int64_t result;        // keep only their low 64 bits
+    std::int64_t guess;
+    std::uint64_t timestamp_ns; // CLOCK_REALTIME
+};
+
+namespace log_format {
+
+constexpr char kMagic[8] = {'O', 'A', 'R', 'L', 'O', 'G', '1', '\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kBlockRecords = 64;
+constexpr std::size_t kMaxTypes = 256;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t block_records;
+};
+
+struct Block {
+    std::uint32_t count;
+    std::uint32_t reserved;
+    std::uint8_t type_index[kBlockRecords];
+    std::uint8_t op[kBlockRecords];
+    std::uint8_t correct[kBlockRecords];
+    std::int64_t start[kBlockRecords];
+    std::int64_t result[kBlockRecords];
+    std::int64_t guess[kBlockRecords];
+    std::uint64_t timestamp_ns[kBlockRecords];
+};
+
+static_assert(sizeof(FileHeader) == 16);
+static_assert(sizeof(Block) == 8 + 3 * kBlockRecords + 32 * kBlockRecords);
+static_assert(kBlockRecords % 16 == 0, "scan works in 16-record SSE2 chunks");
+
+} // namespace log_format
+
+inline std::uint64_t realtime_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+class RoundLogWriter {
+public:
+    static constexpr std::size_t kBufferedBlocks = 16;
+    static constexpr std::uint64_t kFlushAfterNs = 1000000000; // 1 s
+
+    RoundLogWriter() : blocks_(kBufferedBlocks) {}
+    RoundLogWriter(const RoundLogWriter&) = delete;
+    RoundLogWriter& operator=(const RoundLogWriter&) = delete;
+    ~RoundLogWriter() { close(); }
+
+    // Opens (creating if needed) a log for appending. Returns false and
+    // leaves errno set on failure.
+    bool open(const char* path) {
+        close();
+        fd_ = ::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd_, &st) != 0) {
+            close();
+            return false;
+        }
+        if (st.st_size == 0) {
+            log_format::FileHeader header{};
+            std::memcpy(header.magic, log_format::kMagic, sizeof(header.magic));
+            header.version = log_format::kVersion;
+            header.block_records = log_format::kBlockRecords;
+            if (!write_all(&header, sizeof(header))) {
+                close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool is_open() const { return fd_ >= 0; }
+
+    void append(const RoundRecord& r) {
+        log_format::Block& b = blocks_[used_blocks_];
+        if (used_blocks_ == 0 && b.count == 0) oldest_ns_ = r.timestamp_ns;
+        std::size_t i = b.count;
+        b.type_index[i] = r.type_index;
+        b.op[i] = r.op;
+        b.correct[i] = r.correct;
+        b.start[i] = r.start;
+        b.result[i] = r.result;
+        b.guess[i] = r.guess;
+        b.timestamp_ns[i] = r.timestamp_ns;
+        bool full = ++b.count == log_format::kBlockRecords && ++used_blocks_ == blocks_.size();
+        // A clock step backwards wraps to a huge age and just flushes.
+        if (full || r.timestamp_ns - oldest_ns_ >= kFlushAfterNs) {
+            flush();
+        }
+    }
+
+    // Writes every buffered block, including a partly filled last one.
+    bool flush() {
+        std::size_t n = used_blocks_ + (used_blocks_ < blocks_.size() && blocks_[used_blocks_].count > 0 ? 1 : 0);
+        bool ok = true;
+        if (n > 0 && fd_ >= 0) {
+            ok = write_all(blocks_.data(), n * sizeof(log_format::Block));
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            std::memset(&blocks_[i], 0, sizeof(log_format::Block));
+        }
+        used_blocks_ = 0;
+        return ok;
+    }
+
+    void close() {
+        if (fd_ >= 0) {
+            flush();
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+private:
+    bool write_all(const void* data, std::size_t size) {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t n = ::write(fd_, p, size);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    int fd_ = -1;
+    std::vector<log_format::Block> blocks_;
+    std::size_t used_blocks_ = 0;
+    std::uint64_t oldest_ns_ = 0;
+};
+
+struct TypeAccuracy {
+    std::uint64_t rounds[log_format::kMaxTypes] = {};
+    std::uint64_t correct[log_format::kMaxTypes] = {};
+};
+
+enum class LogStatus { ok, bad_header, truncated };
+
+// Adds every round in `data` (a whole log file) to `acc`. Only type
+// indexes below `type_count` are tallied.
+inline LogStatus scan_accuracy(std::string_view data, std::size_t type_count, TypeAccuracy& acc) {
+    using namespace log_format;
+    if (data.size() < sizeof(FileHeader)) {
+        return LogStatus::bad_header;
+    }
+    FileHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.block_records != kBlockRecords) {
+        return LogStatus::bad_header;
+    }
+    data.remove_prefix(sizeof(FileHeader));
+    if (type_count > kMaxTypes) type_count = kMaxTypes;
+
+    const __m128i zero = _mm_setzero_si128();
+    while (data.size() >= sizeof(Block)) {
+        const Block* b = reinterpret_cast<const Block*>(data.data());
+        std::uint32_t count = b->count <= kBlockRecords ? b->count : 0;
+        data.remove_prefix(sizeof(Block));
+
+        for (std::size_t chunk = 0; chunk < kBlockRecords && chunk < count; chunk += 16) {
+            __m128i types = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b->type_index + chunk));
+            __m128i correct = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b->correct + chunk));
+            std::uint32_t live = count - chunk >= 16 ? 0xFFFFu : ((1u << (count - chunk)) - 1u);
+            std::uint32_t right = ~static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(correct, zero))) & live;
+
+            for (std::size_t t = 0; t < type_count; ++t) {
+                __m128i want = _mm_set1_epi8(static_cast<char>(t));
+                std::uint32_t match = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(types, want))) & live;
+                acc.rounds[t] += static_cast<std::uint64_t>(__builtin_popcount(match));
+                acc.correct[t] += static_cast<std::uint64_t>(__builtin_popcount(match & right));
+            }
+        }
+    }
+    return data.empty() ? LogStatus::ok : LogStatus::truncated;
+}
+
+} // namespace arena
@@ -0,0 +1,116 @@
+/*
+    Per-GameType accuracy from binary arena round logs.
+
+    Maps each log read-only and tallies rounds and correct answers per
+    type with arena::scan_accuracy(), several files in parallel.
+
+    Build: g++ -std=c++17 -O2 -pthread arena_log_stats.cpp -o arena_log_stats
+    Usage: arena_log_stats [-j threads] log1 [log2 ...]
+*/
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "arena_core.hpp"
+#include "arena_log.hpp"
+#include "arena_parse.hpp"
+
+namespace {
+
+void usage() {
+    std::cerr << "usage: arena_log_stats [-j threads] log1 [log2 ...]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            if (arena::parse_int(argv[++i], threads, 1u, 1024u) != arena::ParseStatus::ok) {
+                usage();
+                return 1;
+            }
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        usage();
+        return 1;
+    }
+    threads = std::min<unsigned>(threads, static_cast<unsigned>(paths.size()));
+
+    const std::vector<arena::GameType> types = arena::make_game_types();
+    std::vector<arena::TypeAccuracy> partial(threads);
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::uint64_t> bytes_scanned{0};
+    std::atomic<bool> failed{false};
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            for (std::size_t i = next++; i < paths.size(); i = next++) {
+                arena::MappedFile file;
+                if (!file.open(paths[i])) {
+                    std::fprintf(stderr, "%s: %s\n", paths[i], std::strerror(errno));
+                    failed = true;
+                    continue;
+                }
+                arena::LogStatus status = arena::scan_accuracy(file.view(), types.size(), partial[t]);
+                if (status == arena::LogStatus::bad_header) {
+                    std::fprintf(stderr, "%s: not an arena round log\n", paths[i]);
+                    failed = true;
+                } else if (status == arena::LogStatus::truncated) {
+                    std::fprintf(stderr, "%s: ends with a partial block (ignored)\n", paths[i]);
+                }
+                bytes_scanned += file.view().size();
+            }
+        });
+    }
+    for (std::thread& th : pool) {
+        th.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    arena::TypeAccuracy total;
+    for (const arena::TypeAccuracy& p : partial) {
+        for (std::size_t t = 0; t < types.size(); ++t) {
+            total.rounds[t] += p.rounds[t];
+            total.correct[t] += p.correct[t];
+        }
+    }
+
+    std::cout << std::left << std::setw(12) << "type" << std::right << std::setw(14) << "rounds"
+              << std::setw(14) << "correct" << std::setw(10) << "accuracy" << "\n";
+    std::uint64_t all_rounds = 0;
+    std::uint64_t all_correct = 0;
+    for (std::size_t t = 0; t < types.size(); ++t) {
+        double pct = total.rounds[t] ? 100.0 * static_cast<double>(total.correct[t]) / static_cast<double>(total.rounds[t]) : 0.0;
+        std::cout << std::left << std::setw(12) << types[t].name << std::right
+                  << std::setw(14) << total.rounds[t] << std::setw(14) << total.correct[t]
+                  << std::setw(9) << std::fixed << std::setprecision(1) << pct << "%\n";
+        all_rounds += total.rounds[t];
+        all_correct += total.correct[t];
+    }
+    std::cout << std::left << std::setw(12) << "all" << std::right
+              << std::setw(14) << all_rounds << std::setw(14) << all_correct << "\n";
+
+    double gib = static_cast<double>(bytes_scanned.load()) / (1024.0 * 1024.0 * 1024.0);
+    std::cout << "\nScanned " << std::setprecision(3) << gib << " GiB in " << seconds << " s ("
+              << std::setprecision(0) << (seconds > 0 ? static_cast<double>(all_rounds) / seconds : 0.0)
+              << " rounds/s, " << threads << " thread(s))\n";
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,47 @@
+/*
+    Scratch memory for one round (or one lesson) at a time.
+
+    RoundArena is a std::pmr::monotonic_buffer_resource over a buffer
+    that is allocated once, up front. Whatever a round builds comes out
+    of it with a pointer bump, and reset() takes the whole buffer back
+    before the next round, so a round in steady state never calls the
+    global operator new.
+
+    Nothing allocated here may outlive the next reset(). That is also
+    what lets one RoundArena serve every session in a process: rounds
+    are handled one line at a time, and each starts with reset().
+
+    A round that needs more than the buffer still works: the rest comes
+    from operator new and is freed by the next reset(). Build with
+    -DARENA_METRICS to see whether that ever happens (heap_allocs).
+*/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace arena {
+
+class RoundArena {
+public:
+    static constexpr std::size_t kDefaultBytes = 4096;
+
+    explicit RoundArena(std::size_t bytes = kDefaultBytes)
+        : buffer_(std::make_unique<std::byte[]>(bytes)),
+          resource_(buffer_.get(), bytes, std::pmr::new_delete_resource()) {}
+
+    RoundArena(const RoundArena&) = delete;
+    RoundArena& operator=(const RoundArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &resource_; }
+
+    // Frees everything allocated since the last reset().
+    void reset() { resource_.release(); }
+
+private:
+    std::unique_ptr<std::byte[]> buffer_;
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+} // namespace arena
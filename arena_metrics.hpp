@@ -0,0 +1,340 @@
+/*
+    Per-stage timing and counters for Overflow Arena.
+
+    Build with -DARENA_METRICS to turn it on. Without it the macros
+    below expand to nothing, so there is no cost in normal builds.
+
+    ARENA_TIME_SCOPE(stage) reads the TSC at the start and end of the
+    enclosing scope and records the difference in that stage's
+    histogram. Histograms are log-linear (HDR-style): exact below 16
+    cycles, then 8 sub-buckets per power of two, so any percentile is
+    within 12.5%.
+
+    A round has seven timed stages, and timing every one of them on
+    every round costs 10-15% of a CPU-only round. ARENA_SAMPLE_ROUND()
+    therefore times only one round in kSampleEvery (64, which keeps the
+    instrumentation near 9 ns of a ~1 us round; at 16 it was ~25 ns);
+    counters still see every round. Timers outside a round are always
+    on.
+
+    Metrics builds also replace the global operator new to count heap
+    allocations, in total and while a round is being handled; with the
+    round and lesson arenas (arena_memory.hpp) in place the in-round
+    count stays at zero. A program can define operator new only once,
+    so ARENA_METRICS belongs in one translation unit per program, as
+    every arena program is a single file anyway.
+
+    dump_json() writes everything to a file descriptor using only
+    write(2) and stack buffers, so it is also safe to call from the
+    SIGUSR1 handler that install_dump_signal() sets up.
+*/
+#pragma once
+
+#include <cstdint>
+
+#ifdef ARENA_METRICS
+#include <csignal>
+#include <cstddef>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+#include <x86intrin.h>
+#include <unistd.h>
+#endif
+
+namespace arena::metrics {
+
+enum class Stage {
+    round_total,   // handling one guess line, input wait excluded
+    rng_draw,      // RoundDealer::next
+    op_call,       // apply_op on the dealt op
+    wrap_math,     // wrap_signed / wrap_unsigned
+    bit_strings,   // building the before/after bit strings
+    output,        // formatting round text into the output stream
+    console_flush, // writing buffered output before blocking on input
+    tour_run,      // one "Run" step of quick_tour
+    count
+};
+
+enum class Counter {
+    rounds,
+    correct,
+    invalid_guesses,
+    out_of_range_guesses,
+    count
+};
+
+#ifdef ARENA_METRICS
+
+inline constexpr const char* kStageNames[] = {
+    "round_total", "rng_draw", "op_call", "wrap_math",
+    "bit_strings", "output", "console_flush", "tour_run",
+};
+
+inline constexpr const char* kCounterNames[] = {
+    "rounds", "correct", "invalid_guesses", "out_of_range_guesses",
+};
+
+class Histogram {
+public:
+    static constexpr int kBuckets = 16 + 60 * 8;
+
+    void record(std::uint64_t v) {
+        ++buckets_[bucket_of(v)];
+        ++count_;
+        sum_ += v;
+        if (v > max_) max_ = v;
+    }
+
+    std::uint64_t count() const { return count_; }
+    std::uint64_t sum() const { return sum_; }
+    std::uint64_t max() const { return max_; }
+
+    // Lower bound of the bucket holding the p-th percentile (p in 0..100).
+    std::uint64_t percentile(unsigned p) const {
+        if (count_ == 0) return 0;
+        std::uint64_t rank = (count_ * p + 99) / 100;
+        if (rank == 0) rank = 1;
+        std::uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += buckets_[i];
+            if (seen >= rank) return lower_bound(i);
+        }
+        return max_;
+    }
+
+private:
+    static int bucket_of(std::uint64_t v) {
+        if (v < 16) return static_cast<int>(v);
+        int e = 63 - __builtin_clzll(v);
+        int sub = static_cast<int>((v >> (e - 3)) & 7);
+        return 16 + (e - 4) * 8 + sub;
+    }
+
+    static std::uint64_t lower_bound(int index) {
+        if (index < 16) return static_cast<std::uint64_t>(index);
+        int e = (index - 16) / 8 + 4;
+        std::uint64_t sub = static_cast<std::uint64_t>((index - 16) % 8);
+        return (8 + sub) << (e - 3);
+    }
+
+    std::uint64_t buckets_[kBuckets] = {};
+    std::uint64_t count_ = 0;
+    std::uint64_t sum_ = 0;
+    std::uint64_t max_ = 0;
+};
+
+inline std::uint64_t monotonic_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+constexpr std::uint32_t kSampleEvery = 64;
+
+struct Registry {
+    Histogram stages[static_cast<int>(Stage::count)];
+    std::uint64_t counters[static_cast<int>(Counter::count)] = {};
+    std::uint64_t start_tsc = __rdtsc();
+    std::uint64_t start_ns = monotonic_ns();
+    std::uint32_t round_seq = 0;
+    bool timing = true;
+};
+
+inline Registry g_registry;
+
+// Kept out of Registry so they are already valid for allocations made
+// before g_registry is constructed.
+struct HeapCounts {
+    std::uint64_t total;
+    std::uint64_t in_rounds;
+    bool in_round;
+};
+
+inline HeapCounts g_heap{};
+
+inline void count_heap_alloc() {
+    ++g_heap.total;
+    if (g_heap.in_round) ++g_heap.in_rounds;
+}
+
+inline void record(Stage stage, std::uint64_t cycles) {
+    g_registry.stages[static_cast<int>(stage)].record(cycles);
+}
+
+inline void count(Counter counter) {
+    ++g_registry.counters[static_cast<int>(counter)];
+}
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Stage stage)
+        : stage_(stage), active_(g_registry.timing), start_(active_ ? __rdtsc() : 0) {}
+    ~ScopedTimer() {
+        if (active_) record(stage_, __rdtsc() - start_);
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Stage stage_;
+    bool active_;
+    std::uint64_t start_;
+};
+
+// Turns timers off for the rest of this scope unless this round is
+// one of the sampled ones.
+class RoundSample {
+public:
+    RoundSample() {
+        g_registry.timing = (g_registry.round_seq++ % kSampleEvery) == 0;
+        g_heap.in_round = true;
+    }
+    ~RoundSample() {
+        g_registry.timing = true;
+        g_heap.in_round = false;
+    }
+
+    RoundSample(const RoundSample&) = delete;
+    RoundSample& operator=(const RoundSample&) = delete;
+};
+
+// Fixed-size text builder; silently truncates instead of allocating.
+class JsonWriter {
+public:
+    void text(const char* s) {
+        while (*s != '\0') put(*s++);
+    }
+
+    void number(std::uint64_t v) {
+        char digits[20];
+        int n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + v % 10);
+            v /= 10;
+        } while (v != 0);
+        while (n > 0) put(digits[--n]);
+    }
+
+    void field(const char* name, std::uint64_t v, bool comma = true) {
+        put('"');
+        text(name);
+        text("\":");
+        number(v);
+        if (comma) put(',');
+    }
+
+    void flush(int fd) {
+        std::size_t off = 0;
+        while (off < size_) {
+            ssize_t n = ::write(fd, buf_ + off, size_ - off);
+            if (n <= 0) break;
+            off += static_cast<std::size_t>(n);
+        }
+        size_ = 0;
+    }
+
+private:
+    void put(char c) {
+        if (size_ < sizeof(buf_)) buf_[size_++] = c;
+    }
+
+    char buf_[8192];
+    std::size_t size_ = 0;
+};
+
+// Cycles spent by an empty ScopedTimer, to judge how much the
+// instrumentation itself adds to each recorded stage.
+inline std::uint64_t timer_overhead_cycles() {
+    std::uint64_t best = ~0ULL;
+    for (int i = 0; i < 64; ++i) {
+        std::uint64_t a = __rdtsc();
+        std::uint64_t b = __rdtsc();
+        if (b - a < best) best = b - a;
+    }
+    return best;
+}
+
+inline void dump_json(int fd) {
+    const Registry& r = g_registry;
+    std::uint64_t elapsed_ns = monotonic_ns() - r.start_ns;
+    std::uint64_t elapsed_tsc = __rdtsc() - r.start_tsc;
+
+    JsonWriter w;
+    w.text("{");
+    w.field("elapsed_ns", elapsed_ns);
+    w.field("tsc_per_us", elapsed_ns >= 1000 ? elapsed_tsc / (elapsed_ns / 1000) : 0);
+    w.field("timer_overhead_cycles", timer_overhead_cycles());
+    w.field("round_sample_every", kSampleEvery);
+    w.text("\"counters\":{");
+    for (int i = 0; i < static_cast<int>(Counter::count); ++i) {
+        w.field(kCounterNames[i], r.counters[i], i + 1 < static_cast<int>(Counter::count));
+    }
+    w.text("},\"heap_allocs\":{");
+    w.field("total", g_heap.total);
+    w.field("in_rounds", g_heap.in_rounds, false);
+    w.text("},\"stages_cycles\":{");
+    for (int i = 0; i < static_cast<int>(Stage::count); ++i) {
+        const Histogram& h = r.stages[i];
+        w.text("\"");
+        w.text(kStageNames[i]);
+        w.text("\":{");
+        w.field("count", h.count());
+        w.field("mean", h.count() ? h.sum() / h.count() : 0);
+        w.field("p50", h.percentile(50));
+        w.field("p90", h.percentile(90));
+        w.field("p99", h.percentile(99));
+        w.field("max", h.max(), false);
+        w.text(i + 1 < static_cast<int>(Stage::count) ? "}," : "}");
+    }
+    w.text("}}\n");
+    w.flush(fd);
+}
+
+inline void install_dump_signal() {
+    std::signal(SIGUSR1, [](int) { dump_json(STDERR_FILENO); });
+}
+
+#define ARENA_METRICS_CONCAT2(a, b) a##b
+#define ARENA_METRICS_CONCAT(a, b) ARENA_METRICS_CONCAT2(a, b)
+#define ARENA_TIME_SCOPE(stage) \
+    ::arena::metrics::ScopedTimer ARENA_METRICS_CONCAT(arena_timer_, __LINE__)(::arena::metrics::Stage::stage)
+#define ARENA_SAMPLE_ROUND() ::arena::metrics::RoundSample arena_round_sample_
+#define ARENA_COUNT(counter) ::arena::metrics::count(::arena::metrics::Counter::counter)
+
+#else
+
+inline void dump_json(int) {}
+inline void install_dump_signal() {}
+
+#define ARENA_TIME_SCOPE(stage) static_cast<void>(0)
+#define ARENA_SAMPLE_ROUND() static_cast<void>(0)
+#define ARENA_COUNT(counter) static_cast<void>(0)
+
+#endif
+
+} // namespace arena::metrics
+
+#ifdef ARENA_METRICS
+
+void* operator new(std::size_t size) {
+    ::arena::metrics::count_heap_alloc();
+    if (size == 0) size = 1;
+    while (true) {
+        if (void* p = std::malloc(size)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+// Both deletes go through one out-of-line call, so GCC never sees free()
+// applied to what it knows came from operator new once these inline
+// (-Wmismatched-new-delete).
+__attribute__((noinline)) void arena_metrics_free(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p) noexcept { arena_metrics_free(p); }
+void operator delete(void* p, std::size_t) noexcept { arena_metrics_free(p); }
+
+#endif
@@ -0,0 +1,148 @@
+/*
+    Buffered console output for Overflow Arena.
+
+    ConsoleOutput swaps std::cout's buffer for a 64 KiB ConsoleBuffer that
+    writes straight to the file descriptor, turns off stdio sync and
+    unties std::cin. Output then leaves the process only when the buffer
+    fills or when the program flushes before blocking on input, instead
+    of once per << on a terminal.
+
+    StringAppendBuffer is the same idea for arena_server, where each
+    session's output is collected for its socket instead of a terminal.
+*/
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+namespace arena {
+
+class ConsoleBuffer : public std::streambuf {
+public:
+    explicit ConsoleBuffer(int fd, std::size_t size = 64 * 1024) : fd_(fd), buffer_(size) {
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+
+    ~ConsoleBuffer() override { flush_buffer(); }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (!flush_buffer()) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        std::streamsize room = epptr() - pptr();
+        if (n <= room) {
+            traits_type::copy(pptr(), s, static_cast<std::size_t>(n));
+            pbump(static_cast<int>(n));
+            return n;
+        }
+        // Too big to fit: flush what we have and write the block directly.
+        if (!flush_buffer() || !write_all(s, static_cast<std::size_t>(n))) {
+            return 0;
+        }
+        return n;
+    }
+
+    int sync() override { return flush_buffer() ? 0 : -1; }
+
+private:
+    bool write_all(const char* data, std::size_t size) {
+        while (size > 0) {
+            ssize_t written = ::write(fd_, data, size);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    bool flush_buffer() {
+        bool ok = write_all(pbase(), static_cast<std::size_t>(pptr() - pbase()));
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+        return ok;
+    }
+
+    int fd_;
+    std::vector<char> buffer_;
+};
+
+// Installs a ConsoleBuffer on std::cout for its lifetime. Create one at
+// the top of main(); anything that leaves through std::exit() must flush
+// std::cout first.
+class ConsoleOutput {
+public:
+    ConsoleOutput() : buffer_(STDOUT_FILENO) {
+        std::ios::sync_with_stdio(false);
+        std::cin.tie(nullptr);
+        previous_ = std::cout.rdbuf(&buffer_);
+    }
+
+    ~ConsoleOutput() {
+        std::cout.flush();
+        std::cout.rdbuf(previous_);
+    }
+
+    ConsoleOutput(const ConsoleOutput&) = delete;
+    ConsoleOutput& operator=(const ConsoleOutput&) = delete;
+
+private:
+    ConsoleBuffer buffer_;
+    std::streambuf* previous_ = nullptr;
+};
+
+// Dashes for heading underlines, so no string is built per heading.
+inline std::string_view underline(std::size_t width) {
+    static constexpr std::string_view kDashes =
+        "----------------------------------------------------------------"
+        "----------------------------------------------------------------";
+    return kDashes.substr(0, width < kDashes.size() ? width : kDashes.size());
+}
+
+inline void print_heading(std::ostream& out, std::string_view title) {
+    out << "\n" << title << "\n" << underline(title.size()) << "\n";
+}
+
+// Appends everything written through it to a std::string. Lets code
+// that prints to a std::ostream fill a socket's output buffer instead.
+class StringAppendBuffer : public std::streambuf {
+public:
+    explicit StringAppendBuffer(std::string& target) : target_(&target) {}
+
+    void retarget(std::string& target) { target_ = &target; }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            target_->push_back(traits_type::to_char_type(ch));
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        target_->append(s, static_cast<std::size_t>(n));
+        return n;
+    }
+
+private:
+    std::string* target_;
+};
+
+} // namespace arena
@@ -0,0 +1,142 @@
+/*
+    Allocation-free integer parsing for Overflow Arena.
+
+    parse_int() replaces the per-attempt std::stringstream in
+    read_int_from_user() and the per-guess one in overflow_arena().
+    It is built on std::from_chars and checks the value against an
+    explicit [min, max] range, usually the current GameType bounds.
+
+    MappedFile + for_each_line_int() are the bulk mode: map a whole
+    answer file read-only and parse it line by line in place, with no
+    per-line std::string or stream.
+*/
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace arena {
+
+enum class ParseStatus { ok, invalid, out_of_range };
+
+inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+inline std::string_view trim(std::string_view text) {
+    while (!text.empty() && is_blank(text.front())) text.remove_prefix(1);
+    while (!text.empty() && is_blank(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+// Parses the whole of `text` (surrounding whitespace allowed, one
+// leading '+' allowed) into `out`. `out` is only written on ok.
+template <typename T>
+ParseStatus parse_int(std::string_view text, T& out, T min_value, T max_value) {
+    text = trim(text);
+    if (text.size() > 1 && text[0] == '+' && text[1] != '-') {
+        text.remove_prefix(1);
+    }
+    if (text.empty()) {
+        return ParseStatus::invalid;
+    }
+
+    T value{};
+    const char* first = text.data();
+    const char* last = first + text.size();
+    using std::from_chars; // wide_int brings its own via ADL
+    auto [ptr, ec] = from_chars(first, last, value);
+    if (ec == std::errc::result_out_of_range) {
+        return ParseStatus::out_of_range;
+    }
+    if (ec != std::errc() || ptr != last) {
+        return ParseStatus::invalid;
+    }
+    if (value < min_value || value > max_value) {
+        return ParseStatus::out_of_range;
+    }
+    out = value;
+    return ParseStatus::ok;
+}
+
+// Read-only mapping of a whole file. Empty files map to an empty view.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    // Returns false and leaves errno set on failure.
+    bool open(const char* path) {
+        close();
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                size_ = 0;
+                return false;
+            }
+            data_ = static_cast<const char*>(p);
+            madvise(p, size_, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+        return true;
+    }
+
+    void close() {
+        if (data_ != nullptr) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    std::string_view view() const { return std::string_view(data_, size_); }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Calls fn(line_number, status, value) for every non-blank line of
+// `data`. Line numbers start at 1. Returns the number of lines visited.
+template <typename T, typename Fn>
+std::size_t for_each_line_int(std::string_view data, T min_value, T max_value, Fn&& fn) {
+    std::size_t line_number = 0;
+    std::size_t visited = 0;
+    while (!data.empty()) {
+        std::size_t end = data.find('\n');
+        std::string_view line = data.substr(0, end);
+        data.remove_prefix(end == std::string_view::npos ? data.size() : end + 1);
+        ++line_number;
+
+        if (trim(line).empty()) {
+            continue;
+        }
+        T value{};
+        ParseStatus status = parse_int(line, value, min_value, max_value);
+        fn(line_number, status, value);
+        ++visited;
+    }
+    return visited;
+}
+
+} // namespace arena
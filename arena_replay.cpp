@@ -0,0 +1,322 @@
+/*
+    Offline replay and grading for recorded Overflow Arena sessions.
+
+    Log format (one entry per line):
+
+        seed 1234567     starts a session, same value overflow_arena printed
+        255              whatever the player typed at "Your guess:"
+        q                ends the session
+
+    A file may hold any number of sessions; blank lines and '#' comments
+    are allowed between them. Inside a session every line is taken
+    exactly as ArenaSession::handle_line takes it: untrimmed, a 'q' or
+    'Q' in the first column quits, and anything else - a blank line, a
+    comment, " q" - is a guess that deals one round from
+    arena::RoundDealer. So invalid and out-of-range lines still consume
+    a round, and every graded round feeds the dealer's weighting the
+    same way.
+
+    With --check each session is also fed through arena::ArenaSession,
+    the interactive game itself, and its score and round count must
+    match the replay's; any difference is reported and the exit status
+    is 1.
+
+    Files are streamed through a large read buffer and several files are
+    graded in parallel.
+
+    Build: g++ -std=c++17 -O2 -pthread arena_replay.cpp -o arena_replay
+    Usage: arena_replay [-j threads] [--check] log1 [log2 ...]
+*/
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "arena_core.hpp"
+#include "arena_memory.hpp"
+#include "arena_parse.hpp"
+#include "arena_session.hpp"
+#include "lesson_text_en.hpp"
+
+namespace {
+
+constexpr std::size_t kReadBufferSize = 1 << 20;
+
+struct GradeTotals {
+    std::uint64_t sessions = 0;
+    std::uint64_t rounds = 0;
+    std::uint64_t correct = 0;
+    std::uint64_t invalid = 0;
+    std::uint64_t out_of_range = 0;
+    std::uint64_t orphan_lines = 0; // guesses with no open session
+    std::uint64_t mismatched = 0;   // --check: sessions ArenaSession scored differently
+    bool read_error = false;
+
+    void add(const GradeTotals& other) {
+        sessions += other.sessions;
+        rounds += other.rounds;
+        correct += other.correct;
+        invalid += other.invalid;
+        out_of_range += other.out_of_range;
+        orphan_lines += other.orphan_lines;
+        mismatched += other.mismatched;
+        read_error = read_error || other.read_error;
+    }
+};
+
+class Grader {
+public:
+    Grader(const std::vector<arena::GameType>& types, bool check)
+        : types_(types), check_(check), text_(arena::english_catalog()), discard_(nullptr) {}
+
+    void line(std::string_view text) {
+        if (dealer_) {
+            play(text);
+            return;
+        }
+
+        text = arena::trim(text);
+        if (text.empty() || text.front() == '#') {
+            return;
+        }
+        if (text.substr(0, 5) != "seed ") {
+            ++totals_.orphan_lines;
+            return;
+        }
+        std::uint32_t seed = 0;
+        if (arena::parse_int(text.substr(5), seed, std::uint32_t{0},
+                             std::numeric_limits<std::uint32_t>::max()) != arena::ParseStatus::ok) {
+            ++totals_.orphan_lines;
+            return;
+        }
+        dealer_.emplace(seed, types_.size());
+        ++totals_.sessions;
+        session_rounds_ = 0;
+        session_correct_ = 0;
+        if (check_) {
+            session_.emplace(seed, types_, scratch_, text_);
+            session_->begin(discard_);
+        }
+    }
+
+    // Closes a session the file ended in without a 'q'.
+    void finish() { end_session(); }
+
+    const GradeTotals& totals() const { return totals_; }
+    GradeTotals& totals() { return totals_; }
+
+private:
+    // ArenaSession::handle_line's rules, on the untrimmed line.
+    void play(std::string_view text) {
+        if (session_) {
+            session_->handle_line(text, discard_);
+        }
+        if (!text.empty() && (text[0] == 'q' || text[0] == 'Q')) {
+            end_session();
+            return;
+        }
+
+        arena::RoundDraw draw = dealer_->next();
+        const arena::GameType& gt = types_[draw.type_index];
+
+        arena::GameValue guess;
+        arena::ParseStatus status = arena::parse_int(text, guess, gt.min_value, gt.max_value);
+        if (status == arena::ParseStatus::invalid) {
+            ++totals_.invalid;
+            return;
+        }
+        if (status == arena::ParseStatus::out_of_range) {
+            ++totals_.out_of_range;
+            return;
+        }
+
+        arena::GameValue start = arena::start_value(gt, draw.near_max);
+        arena::GameValue result = arena::wrap_to_type(gt, arena::apply_op(draw.op_choice, start));
+        ++totals_.rounds;
+        ++session_rounds_;
+        if (guess == result) {
+            ++totals_.correct;
+            ++session_correct_;
+        }
+        dealer_->record(draw, guess == result);
+    }
+
+    void end_session() {
+        if (session_) {
+            if (static_cast<std::uint64_t>(session_->rounds()) != session_rounds_ ||
+                static_cast<std::uint64_t>(session_->score()) != session_correct_) {
+                ++totals_.mismatched;
+            }
+            session_.reset();
+        }
+        dealer_.reset();
+    }
+
+    const std::vector<arena::GameType>& types_;
+    bool check_;
+    std::optional<arena::RoundDealer> dealer_;
+    std::uint64_t session_rounds_ = 0;
+    std::uint64_t session_correct_ = 0;
+    GradeTotals totals_;
+
+    // --check only: the interactive game, its output thrown away.
+    arena::LessonCatalog text_;
+    arena::RoundArena scratch_;
+    std::ostream discard_;
+    std::optional<arena::ArenaSession> session_;
+};
+
+GradeTotals grade_file(const char* path, const std::vector<arena::GameType>& types, bool check,
+                       std::vector<char>& buffer) {
+    Grader grader(types, check);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::fprintf(stderr, "%s: %s\n", path, std::strerror(errno));
+        grader.totals().read_error = true;
+        return grader.totals();
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    // [0, filled) holds bytes not yet split into lines.
+    std::size_t filled = 0;
+    bool skipping_long_line = false;
+    while (true) {
+        ssize_t n = read(fd, buffer.data() + filled, buffer.size() - filled);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::fprintf(stderr, "%s: %s\n", path, std::strerror(errno));
+            grader.totals().read_error = true;
+            break;
+        }
+        if (n == 0) {
+            if (filled > 0 && !skipping_long_line) {
+                grader.line(std::string_view(buffer.data(), filled));
+            }
+            break;
+        }
+        filled += static_cast<std::size_t>(n);
+
+        std::size_t begin = 0;
+        while (true) {
+            const char* nl = static_cast<const char*>(
+                std::memchr(buffer.data() + begin, '\n', filled - begin));
+            if (nl == nullptr) break;
+            std::size_t end = static_cast<std::size_t>(nl - buffer.data());
+            if (!skipping_long_line) {
+                grader.line(std::string_view(buffer.data() + begin, end - begin));
+            }
+            skipping_long_line = false;
+            begin = end + 1;
+        }
+
+        if (begin == 0 && filled == buffer.size()) {
+            // A single line longer than the buffer can't be a guess.
+            if (!skipping_long_line) {
+                ++grader.totals().invalid;
+            }
+            skipping_long_line = true;
+            filled = 0;
+            continue;
+        }
+        std::memmove(buffer.data(), buffer.data() + begin, filled - begin);
+        filled -= begin;
+    }
+
+    close(fd);
+    grader.finish();
+    return grader.totals();
+}
+
+void usage() {
+    std::cerr << "usage: arena_replay [-j threads] [--check] log1 [log2 ...]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    bool check = false;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            if (arena::parse_int(argv[++i], threads, 1u, 1024u) != arena::ParseStatus::ok) {
+                usage();
+                return 1;
+            }
+        } else if (arg == "--check") {
+            check = true;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        usage();
+        return 1;
+    }
+    threads = std::min<unsigned>(threads, static_cast<unsigned>(paths.size()));
+
+    const std::vector<arena::GameType> types = arena::make_game_types();
+    std::vector<GradeTotals> results(paths.size());
+    std::atomic<std::size_t> next{0};
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&] {
+            std::vector<char> buffer(kReadBufferSize);
+            for (std::size_t i = next++; i < paths.size(); i = next++) {
+                results[i] = grade_file(paths[i], types, check, buffer);
+            }
+        });
+    }
+    for (std::thread& th : pool) {
+        th.join();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    GradeTotals all;
+    std::cout << std::left << std::setw(32) << "log" << std::right
+              << std::setw(10) << "sessions" << std::setw(12) << "rounds"
+              << std::setw(12) << "correct" << std::setw(10) << "invalid" << "\n";
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        const GradeTotals& r = results[i];
+        std::cout << std::left << std::setw(32) << paths[i] << std::right
+                  << std::setw(10) << r.sessions << std::setw(12) << r.rounds
+                  << std::setw(12) << r.correct
+                  << std::setw(10) << (r.invalid + r.out_of_range) << "\n";
+        all.add(r);
+    }
+
+    double seconds = std::chrono::duration<double>(t1 - t0).count();
+    double accuracy = all.rounds ? 100.0 * static_cast<double>(all.correct) / static_cast<double>(all.rounds) : 0.0;
+    std::cout << "\nTotal: " << all.correct << "/" << all.rounds << " correct ("
+              << std::fixed << std::setprecision(1) << accuracy << "%) in "
+              << all.sessions << " sessions\n";
+    if (all.orphan_lines > 0) {
+        std::cout << "Skipped " << all.orphan_lines << " lines outside any session\n";
+    }
+    if (check) {
+        std::cout << "Checked against ArenaSession: " << all.mismatched << " session(s) scored differently\n";
+    }
+    std::cout << "Graded " << std::setprecision(0)
+              << (seconds > 0 ? static_cast<double>(all.rounds) / seconds : 0.0)
+              << " rounds/s on " << threads << " thread(s) ("
+              << std::setprecision(3) << seconds << " s)\n";
+
+    return all.read_error || all.mismatched > 0 ? 1 : 0;
+}
@@ -0,0 +1,401 @@
+/*
+    Overflow Arena server: many game sessions in one process.
+
+    Listens on a Unix domain socket and runs one arena::ArenaSession per
+    connection from a single epoll loop. The protocol is the interactive
+    game itself: the server sends the same text overflow_arena prints,
+    the client sends one line per "Your guess:" prompt, and 'q' ends the
+    session and closes the connection.
+
+    Build: g++ -std=c++17 -O2 arena_server.cpp -o arena_server
+    Usage: arena_server [--socket PATH] [--seed N] [--log FILE] [--catalog FILE]
+           --seed N gives connection i the seed N + i, otherwise each
+           session gets a fresh random seed.
+           --log FILE appends every graded round to a binary round log.
+           --catalog FILE maps a compiled lesson catalog (lesson_catalog)
+           instead of the built-in English text.
+*/
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "arena_core.hpp"
+#include "arena_log.hpp"
+#include "arena_memory.hpp"
+#include "arena_output.hpp"
+#include "arena_parse.hpp"
+#include "arena_session.hpp"
+#include "lesson_catalog.hpp"
+#include "lesson_text_en.hpp"
+
+namespace {
+
+constexpr std::size_t kMaxLineLength = 4096;
+constexpr int kMaxEvents = 1024;
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void on_signal(int) { g_stop = 1; }
+
+struct Connection {
+    Connection(int fd_in, std::uint32_t seed, const std::vector<arena::GameType>& types,
+               arena::RoundArena& scratch, const arena::LessonCatalog& text)
+        : fd(fd_in), session(seed, types, scratch, text) {}
+
+    int fd;
+    std::string in;           // bytes after the last complete line
+    std::string out;          // bytes not yet accepted by the socket
+    std::size_t out_sent = 0;
+    std::uint32_t interest = EPOLLIN; // events registered with epoll
+    bool closing = false;     // close once `out` has drained
+    bool write_failed = false; // peer stopped reading; output is discarded
+    std::uint32_t generation = 0; // tells a reused fd's events apart
+    arena::ArenaSession session;
+};
+
+class Server {
+public:
+    Server(int listen_fd, int epoll_fd, bool fixed_seed, std::uint32_t seed,
+           arena::RoundLogWriter* round_log, const arena::LessonCatalog& text)
+        : listen_fd_(listen_fd), epoll_fd_(epoll_fd), fixed_seed_(fixed_seed),
+          next_seed_(seed), round_log_(round_log), text_(text), types_(arena::make_game_types()),
+          sink_(scratch_), sink_stream_(&sink_) {}
+
+    int run() {
+        epoll_event events[kMaxEvents];
+        while (!g_stop) {
+            int n = epoll_wait(epoll_fd_, events, kMaxEvents, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                perror("epoll_wait");
+                return 1;
+            }
+            for (int i = 0; i < n; ++i) {
+                std::uint64_t key = events[i].data.u64;
+                if (key == kListenKey) {
+                    accept_all();
+                    continue;
+                }
+                // An earlier event in this batch may have dropped the
+                // connection and accept_all() reused its fd; the
+                // generation in the key keeps stale events off the new one.
+                Connection* c = find(key);
+                if (c == nullptr) continue;
+                std::uint32_t ready = events[i].events;
+                // Read before acting on a hang-up: a client that sends its
+                // last lines and closes at once still gets them handled.
+                if (ready & (EPOLLIN | EPOLLHUP)) {
+                    if (!on_readable(c)) continue;
+                } else if (ready & EPOLLERR) {
+                    drop(c);
+                    continue;
+                }
+                if (ready & EPOLLOUT) {
+                    flush(c);
+                }
+            }
+        }
+        for (std::unique_ptr<Connection>& c : connections_) {
+            if (c) drop(c.get());
+        }
+        return 0;
+    }
+
+    std::uint64_t sessions_served() const { return sessions_served_; }
+    std::uint64_t lines_handled() const { return lines_handled_; }
+
+    // epoll data for the listening socket; connections use
+    // generation << 32 | fd with generation >= 1.
+    static constexpr std::uint64_t kListenKey = 0;
+
+private:
+    static std::uint64_t key_of(const Connection* c) {
+        return std::uint64_t{c->generation} << 32 | static_cast<std::uint32_t>(c->fd);
+    }
+
+    Connection* find(std::uint64_t key) {
+        std::size_t fd = static_cast<std::uint32_t>(key);
+        if (fd >= connections_.size()) return nullptr;
+        Connection* c = connections_[fd].get();
+        return c != nullptr && c->generation == key >> 32 ? c : nullptr;
+    }
+
+    void accept_all() {
+        while (true) {
+            int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) perror("accept4");
+                return;
+            }
+
+            std::uint32_t seed = fixed_seed_ ? next_seed_++ : std::random_device{}();
+            if (connections_.size() <= static_cast<std::size_t>(fd)) {
+                connections_.resize(static_cast<std::size_t>(fd) + 1);
+            }
+            connections_[static_cast<std::size_t>(fd)] = std::make_unique<Connection>(fd, seed, types_, round_arena_, text_);
+            Connection* c = connections_[static_cast<std::size_t>(fd)].get();
+            c->generation = next_generation_++;
+            if (next_generation_ == 0) next_generation_ = 1;
+            c->session.set_log(round_log_);
+            ++sessions_served_;
+
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u64 = key_of(c);
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+                perror("epoll_ctl");
+                close(fd);
+                connections_[static_cast<std::size_t>(fd)].reset();
+                continue;
+            }
+
+            sink_.retarget(c->out);
+            c->session.begin(sink_stream_);
+            flush(c);
+        }
+    }
+
+    // Returns false if the connection was dropped. At end of input, or
+    // on a read error (ECONNRESET when the peer closed with our output
+    // unread), the complete lines already received are still played and
+    // the connection closes once their output has drained; a client
+    // that only shut down its write side gets every reply.
+    bool on_readable(Connection* c) {
+        char buf[4096];
+        bool eof = false;
+        while (true) {
+            ssize_t n = read(c->fd, buf, sizeof(buf));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                eof = true;
+                break;
+            }
+            if (n == 0) {
+                eof = true;
+                break;
+            }
+            if (!c->closing) {
+                c->in.append(buf, static_cast<std::size_t>(n));
+            }
+        }
+
+        sink_.retarget(c->out);
+        std::size_t begin = 0;
+        while (!c->closing) {
+            std::size_t nl = c->in.find('\n', begin);
+            if (nl == std::string::npos) break;
+            std::string_view line(c->in.data() + begin, nl - begin);
+            ++lines_handled_;
+            if (!c->session.handle_line(line, sink_stream_)) {
+                c->closing = true;
+            }
+            begin = nl + 1;
+        }
+        c->in.erase(0, begin);
+        if (c->in.size() > kMaxLineLength || (eof && c->write_failed)) {
+            drop(c);
+            return false;
+        }
+        if (eof) c->closing = true;
+        return flush(c);
+    }
+
+    // Writes as much pending output as the socket takes. Returns false
+    // if the connection was dropped.
+    bool flush(Connection* c) {
+        while (!c->write_failed && c->out_sent < c->out.size()) {
+            ssize_t n = send(c->fd, c->out.data() + c->out_sent, c->out.size() - c->out_sent,
+                             MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                // The peer has closed. Lines it sent first may still be
+                // unread, so keep reading until EOF and drop the output.
+                c->write_failed = true;
+                break;
+            }
+            c->out_sent += static_cast<std::size_t>(n);
+        }
+        if (c->write_failed) {
+            c->out.clear();
+            c->out_sent = 0;
+        }
+
+        bool drained = c->out_sent == c->out.size();
+        if (drained) {
+            c->out.clear();
+            c->out_sent = 0;
+            if (c->closing) {
+                drop(c);
+                return false;
+            }
+        }
+        // A closing connection reads nothing more (at EOF, EPOLLIN would
+        // fire on every wait) and only waits to drain.
+        std::uint32_t interest = c->closing ? EPOLLOUT : drained ? EPOLLIN : (EPOLLIN | EPOLLOUT);
+        if (interest != c->interest) {
+            epoll_event ev{};
+            ev.events = interest;
+            ev.data.u64 = key_of(c);
+            epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, c->fd, &ev);
+            c->interest = interest;
+        }
+        return true;
+    }
+
+    void drop(Connection* c) {
+        int fd = c->fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections_[static_cast<std::size_t>(fd)].reset();
+    }
+
+    int listen_fd_;
+    int epoll_fd_;
+    bool fixed_seed_;
+    std::uint32_t next_seed_;
+    arena::RoundLogWriter* round_log_;
+    arena::LessonCatalog text_;
+    std::vector<arena::GameType> types_;
+    std::vector<std::unique_ptr<Connection>> connections_; // indexed by fd
+
+    // One stream for all sessions, pointed at whichever connection is
+    // being served. Safe because the loop is single-threaded.
+    std::string scratch_;
+    arena::StringAppendBuffer sink_;
+    std::ostream sink_stream_;
+
+    // Per-round scratch, shared the same way: each session resets it at
+    // the start of every line it handles.
+    arena::RoundArena round_arena_;
+
+    std::uint64_t sessions_served_ = 0;
+    std::uint64_t lines_handled_ = 0;
+    std::uint32_t next_generation_ = 1;
+};
+
+void raise_fd_limit() {
+    rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+}
+
+void usage() {
+    std::cerr << "usage: arena_server [--socket PATH] [--seed N] [--log FILE] [--catalog FILE]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string socket_path = "/tmp/overflow_arena.sock";
+    bool fixed_seed = false;
+    std::uint32_t seed = 0;
+    arena::RoundLogWriter round_log;
+    arena::LessonCatalog text = arena::english_catalog();
+    arena::CatalogFile catalog_file;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (arg == "--seed" && i + 1 < argc) {
+            if (arena::parse_int(argv[++i], seed, std::uint32_t{0},
+                                 std::numeric_limits<std::uint32_t>::max()) != arena::ParseStatus::ok) {
+                usage();
+                return 1;
+            }
+            fixed_seed = true;
+        } else if (arg == "--log" && i + 1 < argc) {
+            if (!round_log.open(argv[++i])) {
+                perror(argv[i]);
+                return 1;
+            }
+        } else if (arg == "--catalog" && i + 1 < argc) {
+            arena::CatalogStatus status = catalog_file.open(argv[++i]);
+            if (status == arena::CatalogStatus::io_error) {
+                perror(argv[i]);
+                return 1;
+            }
+            if (status != arena::CatalogStatus::ok) {
+                std::cerr << argv[i] << ": not a lesson catalog for this build\n";
+                return 1;
+            }
+            text = catalog_file.catalog();
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "socket path too long\n";
+        return 1;
+    }
+    std::memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    raise_fd_limit();
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        perror("socket");
+        return 1;
+    }
+    unlink(socket_path.c_str());
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        perror("bind");
+        return 1;
+    }
+    if (listen(listen_fd, SOMAXCONN) != 0) {
+        perror("listen");
+        return 1;
+    }
+
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        perror("epoll_create1");
+        return 1;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = Server::kListenKey;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) != 0) {
+        perror("epoll_ctl");
+        return 1;
+    }
+
+    std::cout << "Overflow Arena server listening on " << socket_path << std::endl;
+
+    Server server(listen_fd, epoll_fd, fixed_seed, seed, round_log.is_open() ? &round_log : nullptr, text);
+    int status = server.run();
+    round_log.close();
+
+    close(epoll_fd);
+    close(listen_fd);
+    unlink(socket_path.c_str());
+    std::cout << "Served " << server.sessions_served() << " sessions, "
+              << server.lines_handled() << " lines\n";
+    return status;
+}
@@ -0,0 +1,191 @@
+/*
+    One Overflow Arena game as a line-driven state machine.
+
+    ArenaSession holds what used to be overflow_arena()'s locals (dealer,
+    score, rounds, current GameType) and is fed one input line at a time.
+    Graded rounds can also be appended to a binary RoundLogWriter and
+    counted on a shared Leaderboard slot.
+    Per-round scratch (the bit strings) comes from a RoundArena that is
+    reset at the start of every line, and may be shared by sessions.
+    All text comes from a LessonCatalog.
+    overflow_arena() drives it from std::cin; arena_server drives
+    thousands of them from sockets.
+*/
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arena_core.hpp"
+#include "arena_leaderboard.hpp"
+#include "arena_log.hpp"
+#include "arena_memory.hpp"
+#include "arena_metrics.hpp"
+#include "arena_parse.hpp"
+#include "lesson_catalog.hpp"
+
+namespace arena {
+
+class ArenaSession {
+public:
+    ArenaSession(std::uint32_t seed, const std::vector<GameType>& types, RoundArena& scratch,
+                 const LessonCatalog& text)
+        : types_(&types), scratch_(&scratch), text_(&text), dealer_(seed, types.size()), seed_(seed) {}
+
+    // A player who hangs up instead of quitting gets their rounds
+    // written too.
+    ~ArenaSession() {
+        if (log_ != nullptr) log_->flush();
+    }
+
+    // Intro text followed by the first round's prompt.
+    void begin(std::ostream& out) {
+        say(out, Text::arena_intro, seed_);
+        deal(out);
+    }
+
+    // Handles one line typed at "Your guess:". Returns false once the
+    // player quits; otherwise the next round's prompt has been written.
+    bool handle_line(std::string_view line, std::ostream& out) {
+        ARENA_SAMPLE_ROUND();
+        ARENA_TIME_SCOPE(round_total);
+        scratch_->reset();
+        if (!line.empty() && (line[0] == 'q' || line[0] == 'Q')) {
+            say(out, Text::arena_quit, score_, rounds_);
+            if (log_ != nullptr) log_->flush();
+            return false;
+        }
+
+        GameValue user_guess;
+        ParseStatus status = parse_int(line, user_guess, gt_->min_value, gt_->max_value);
+        if (status == ParseStatus::invalid) {
+            ARENA_COUNT(invalid_guesses);
+            say(out, Text::guess_invalid);
+            deal(out);
+            return true;
+        }
+        if (status == ParseStatus::out_of_range) {
+            ARENA_COUNT(out_of_range_guesses);
+            say(out, Text::guess_out_of_range, gt_->min_value, gt_->max_value);
+            deal(out);
+            return true;
+        }
+
+        grade(user_guess, out);
+        deal(out);
+        return true;
+    }
+
+    // Every graded round is also appended here, if set.
+    void set_log(RoundLogWriter* log) { log_ = log; }
+
+    // ...and counted on this leaderboard slot, if set.
+    void set_leaderboard(LeaderboardSlot* slot) { board_ = slot; }
+
+    int score() const { return score_; }
+    int rounds() const { return rounds_; }
+
+private:
+    void deal(std::ostream& out) {
+        {
+            ARENA_TIME_SCOPE(rng_draw);
+            draw_ = dealer_.next();
+        }
+        gt_ = &(*types_)[draw_.type_index];
+        start_ = start_value(*gt_, draw_.near_max);
+
+        ARENA_TIME_SCOPE(output);
+        say(out, Text::round_header, rounds_ + 1, gt_->name, start_, op_name(draw_.op_choice));
+        say(out, gt_->is_signed ? Text::hint_signed : Text::hint_unsigned);
+        say(out, Text::round_prompt);
+    }
+
+    void grade(const GameValue& user_guess, std::ostream& out) {
+        const GameType& gt = *gt_;
+        GameValue start = start_;
+
+        GameValue wide_before = start;
+        GameValue wide_after;
+        {
+            ARENA_TIME_SCOPE(op_call);
+            wide_after = apply_op(draw_.op_choice, wide_before);
+        }
+        GameValue final_value;
+        {
+            ARENA_TIME_SCOPE(wrap_math);
+            if (gt.is_signed) {
+                final_value = wrap_signed(wide_after, gt.bits);
+            } else {
+                final_value = wrap_unsigned(wide_after, gt.bits);
+            }
+        }
+
+        std::pmr::string before_bits(scratch_->resource());
+        std::pmr::string after_bits(scratch_->resource());
+        {
+            ARENA_TIME_SCOPE(bit_strings);
+            make_bit_strings(gt, start, final_value, before_bits, after_bits);
+        }
+
+        ARENA_TIME_SCOPE(output);
+        say(out, Text::round_run, final_value, gt.min_value, gt.max_value);
+        say(out, Text::bits_intro, before_bits, after_bits);
+        say(out, gt.is_signed ? Text::explain_signed : Text::explain_unsigned);
+
+        if (user_guess == final_value) {
+            score_++;
+            ARENA_COUNT(correct);
+            say(out, Text::round_correct);
+        } else {
+            say(out, Text::round_wrong, user_guess);
+        }
+
+        rounds_++;
+        ARENA_COUNT(rounds);
+        dealer_.record(draw_, user_guess == final_value);
+        if (log_ != nullptr) {
+            log_->append({static_cast<std::uint8_t>(draw_.type_index),
+                          static_cast<std::uint8_t>(draw_.op_choice),
+                          static_cast<std::uint8_t>(user_guess == final_value),
+                          static_cast<std::int64_t>(start.low64()),
+                          static_cast<std::int64_t>(final_value.low64()),
+                          static_cast<std::int64_t>(user_guess.low64()), realtime_ns()});
+        }
+        if (board_ != nullptr) {
+            board_->record_round(user_guess == final_value);
+        }
+        say(out, Text::round_score, score_, rounds_);
+    }
+
+    template <typename... Args>
+    void say(std::ostream& out, Text id, const Args&... args) const {
+        print_text(out, (*text_)[id], args...);
+    }
+
+    static void make_bit_strings(const GameType& gt, const GameValue& start, const GameValue& final_value,
+                                 std::pmr::string& before_bits, std::pmr::string& after_bits) {
+        before_bits.resize(static_cast<std::size_t>(gt.bits));
+        after_bits.resize(static_cast<std::size_t>(gt.bits));
+        start.write_binary(before_bits.data(), gt.bits);
+        final_value.write_binary(after_bits.data(), gt.bits);
+    }
+
+    const std::vector<GameType>* types_;
+    RoundArena* scratch_;
+    const LessonCatalog* text_;
+    RoundDealer dealer_;
+    std::uint32_t seed_;
+    RoundLogWriter* log_ = nullptr;
+    LeaderboardSlot* board_ = nullptr;
+    RoundDraw draw_{};
+    const GameType* gt_ = nullptr;
+    GameValue start_;
+    int score_ = 0;
+    int rounds_ = 0;
+};
+
+} // namespace arena
@@ -0,0 +1,115 @@
+/*
+    Top players on a shared arena leaderboard (arena_leaderboard.hpp).
+
+    Maps the board read-only and prints the top K of a seqlock-consistent
+    snapshot: player, pid, correct answers, rounds, accuracy, whether the
+    process is still running and when it last finished a round. Reading
+    never blocks the games. With -i it redraws every SECONDS; --remove
+    deletes the board's name instead.
+
+    Build: g++ -std=c++17 -O2 arena_top.cpp -o arena_top
+    Usage: arena_top [--board NAME] [-k K] [-i SECONDS] [--remove]
+           The default board is "overflow_arena", as used by
+           overflow_arena --board overflow_arena.
+*/
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+#include "arena_leaderboard.hpp"
+#include "arena_log.hpp"
+#include "arena_parse.hpp"
+
+namespace {
+
+void usage() {
+    std::cerr << "usage: arena_top [--board NAME] [-k K] [-i SECONDS] [--remove]\n";
+}
+
+void print_top(const arena::Leaderboard& board, const char* name, unsigned k) {
+    std::size_t stuck = 0;
+    std::vector<arena::LeaderboardRow> rows = board.snapshot(&stuck);
+    std::size_t players = rows.size();
+    std::size_t live = 0;
+    for (const arena::LeaderboardRow& row : rows) {
+        if (arena::process_alive(row.pid)) ++live;
+    }
+    std::vector<arena::LeaderboardRow> best = arena::Leaderboard::top(std::move(rows), k);
+
+    std::cout << name << ": " << players << " player(s), " << live << " running";
+    if (stuck > 0) std::cout << ", " << stuck << " mid-update";
+    std::cout << "\n";
+    std::cout << std::left << std::setw(5) << "rank" << std::setw(33) << "player" << std::right << std::setw(8)
+              << "pid" << std::setw(9) << "correct" << std::setw(9) << "rounds" << std::setw(8) << "acc%"
+              << std::setw(6) << "live" << std::setw(11) << "last round" << "\n";
+    std::uint64_t now = arena::realtime_ns();
+    for (std::size_t i = 0; i < best.size(); ++i) {
+        const arena::LeaderboardRow& row = best[i];
+        double accuracy = row.rounds > 0 ? 100.0 * row.score / row.rounds : 0.0;
+        double ago = now > row.updated_ns ? static_cast<double>(now - row.updated_ns) / 1e9 : 0.0;
+        std::cout << std::left << std::setw(5) << i + 1 << std::setw(33) << row.name << std::right << std::setw(8)
+                  << row.pid << std::setw(9) << row.score << std::setw(9) << row.rounds << std::fixed
+                  << std::setprecision(1) << std::setw(8) << accuracy << std::setw(6)
+                  << (arena::process_alive(row.pid) ? "yes" : "no") << std::setw(9) << ago << " s" << "\n";
+    }
+    std::cout.flush();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* name = "overflow_arena";
+    unsigned k = 10;
+    unsigned interval = 0;
+    bool remove = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool ok = true;
+        if (arg == "--board" && i + 1 < argc) {
+            name = argv[++i];
+        } else if (arg == "-k" && i + 1 < argc) {
+            ok = arena::parse_int(argv[++i], k, 1u, arena::leaderboard_format::kCapacity) == arena::ParseStatus::ok;
+        } else if (arg == "-i" && i + 1 < argc) {
+            ok = arena::parse_int(argv[++i], interval, 1u, 3600u) == arena::ParseStatus::ok;
+        } else if (arg == "--remove") {
+            remove = true;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            usage();
+            return 1;
+        }
+    }
+
+    if (remove) {
+        if (!arena::Leaderboard::remove(name)) {
+            perror(name);
+            return 1;
+        }
+        return 0;
+    }
+
+    arena::Leaderboard board;
+    arena::BoardStatus status = board.open_read_only(name);
+    if (status == arena::BoardStatus::io_error) {
+        perror(name);
+        return 1;
+    }
+    if (status != arena::BoardStatus::ok) {
+        std::cerr << name << ": not an arena leaderboard\n";
+        return 1;
+    }
+    print_top(board, name, k);
+    while (interval > 0) {
+        sleep(interval);
+        std::cout << "\n";
+        print_top(board, name, k);
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+/*
+    Header-only arithmetic helpers shared by the HW1 programs.
+
+    One template per operation replaces the nine hand-written
+    add32/mul32/div32/add64/.../divDouble functions from HW1_5.
+    Because the bodies live in the header and are constexpr, every
+    caller sees them: the compiler can inline them, fold them at
+    compile time and vectorize loops that use them.
+
+    Works for any arithmetic type (int32_t, int64_t, double, ...).
+    Integer division by zero is still undefined, same as the
+    original functions.
+*/
+#pragma once
+
+#include <type_traits>
+
+namespace arith {
+
+template <typename T>
+constexpr T add(T a, T b) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "arith:: needs an arithmetic type");
+    return a + b;
+}
+
+template <typename T>
+constexpr T sub(T a, T b) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "arith:: needs an arithmetic type");
+    return a - b;
+}
+
+template <typename T>
+constexpr T mul(T a, T b) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "arith:: needs an arithmetic type");
+    return a * b;
+}
+
+template <typename T>
+constexpr T div(T a, T b) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "arith:: needs an arithmetic type");
+    return a / b;
+}
+
+} // namespace arith
@@ -0,0 +1,98 @@
+/*
+    Benchmark for arith.hpp.
+
+    Compares the header-only arith:: templates against out-of-line
+    copies of the old HW1_5 functions. The out-of-line versions are
+    marked noinline so they behave like functions defined in another
+    translation unit: one call per element and no vectorization.
+
+    Build: g++ -std=c++17 -O2 arith_bench.cpp -o arith_bench
+*/
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "arith.hpp"
+
+namespace {
+
+// Folded at compile time, so the header versions really are constexpr.
+static_assert(arith::add<std::int32_t>(40, 2) == 42);
+static_assert(arith::mul<std::int64_t>(1LL << 20, 1LL << 20) == (1LL << 40));
+static_assert(arith::div(10.0, 4.0) == 2.5);
+
+[[gnu::noinline]] std::int32_t add32(std::int32_t a, std::int32_t b) { return a + b; }
+[[gnu::noinline]] std::int32_t mul32(std::int32_t a, std::int32_t b) { return a * b; }
+[[gnu::noinline]] std::int64_t add64(std::int64_t a, std::int64_t b) { return a + b; }
+[[gnu::noinline]] std::int64_t mul64(std::int64_t a, std::int64_t b) { return a * b; }
+[[gnu::noinline]] double addDouble(double a, double b) { return a + b; }
+[[gnu::noinline]] double mulDouble(double a, double b) { return a * b; }
+
+constexpr std::size_t kElements = 1 << 16;
+constexpr int kRepeats = 2000;
+
+template <typename T, typename Fn>
+double ns_per_element(const std::vector<T>& a, const std::vector<T>& b, std::vector<T>& out, Fn fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRepeats; ++r) {
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            out[i] = fn(a[i], b[i]);
+        }
+        // Keep the compiler from hoisting the loop out of the repeat loop.
+        asm volatile("" : : "r"(out.data()) : "memory");
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    return ns / (static_cast<double>(kRepeats) * static_cast<double>(a.size()));
+}
+
+template <typename T, typename Inline, typename OutOfLine>
+void compare(const char* name, Inline inline_fn, OutOfLine out_of_line_fn) {
+    std::vector<T> a(kElements), b(kElements), out(kElements);
+    for (std::size_t i = 0; i < kElements; ++i) {
+        a[i] = static_cast<T>(i % 1000 + 1);
+        b[i] = static_cast<T>(i % 7 + 1);
+    }
+
+    double header = ns_per_element(a, b, out, inline_fn);
+    double called = ns_per_element(a, b, out, out_of_line_fn);
+
+    std::cout << std::left << std::setw(14) << name
+              << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << header
+              << std::setw(14) << called
+              << std::setw(10) << std::setprecision(1) << (called / header) << "x\n";
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::left << std::setw(14) << "op"
+              << std::right << std::setw(12) << "arith ns"
+              << std::setw(14) << "out-of-line"
+              << std::setw(11) << "speedup" << "\n";
+    std::cout << std::string(51, '-') << "\n";
+
+    compare<std::int32_t>("add int32",
+                          [](std::int32_t x, std::int32_t y) { return arith::add(x, y); },
+                          [](std::int32_t x, std::int32_t y) { return add32(x, y); });
+    compare<std::int32_t>("mul int32",
+                          [](std::int32_t x, std::int32_t y) { return arith::mul(x, y); },
+                          [](std::int32_t x, std::int32_t y) { return mul32(x, y); });
+    compare<std::int64_t>("add int64",
+                          [](std::int64_t x, std::int64_t y) { return arith::add(x, y); },
+                          [](std::int64_t x, std::int64_t y) { return add64(x, y); });
+    compare<std::int64_t>("mul int64",
+                          [](std::int64_t x, std::int64_t y) { return arith::mul(x, y); },
+                          [](std::int64_t x, std::int64_t y) { return mul64(x, y); });
+    compare<double>("add double",
+                    [](double x, double y) { return arith::add(x, y); },
+                    [](double x, double y) { return addDouble(x, y); });
+    compare<double>("mul double",
+                    [](double x, double y) { return arith::mul(x, y); },
+                    [](double x, double y) { return mulDouble(x, y); });
+    return 0;
+}
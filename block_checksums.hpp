@@ -0,0 +1,207 @@
+/*
+    Per-block CRC32C checksums for written files, kept in a sidecar
+    file next to the data (data.bin -> data.bin.crc32c).
+
+    Sidecar layout (little-endian): a 24-byte SidecarHeader (magic
+    "OACRC32C", version, block size, data file size), then one uint32
+    CRC32C per block_size bytes of the data file; the last block may be
+    short. A sidecar leaves the data file byte-for-byte what the writer
+    meant it to be, so other tools read it unchanged, and a damaged
+    block is located to within block_size bytes.
+
+    BlockChecksummer computes the CRCs while the data streams past in
+    buffers of any size. verify_blocks() maps the data file and checks
+    the blocks on several threads at once.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "arena_parse.hpp"
+#include "crc32c.hpp"
+
+namespace fileio {
+
+namespace sidecar_format {
+
+constexpr char kMagic[8] = {'O', 'A', 'C', 'R', 'C', '3', '2', 'C'};
+constexpr std::uint32_t kVersion = 1;
+constexpr const char* kSuffix = ".crc32c";
+
+struct SidecarHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t block_size;
+    std::uint64_t file_size;
+};
+
+static_assert(sizeof(SidecarHeader) == 24);
+
+} // namespace sidecar_format
+
+class BlockChecksummer {
+public:
+    explicit BlockChecksummer(std::uint32_t block_size) : block_size_(std::max<std::uint32_t>(block_size, 1)) {}
+
+    std::uint32_t block_size() const { return block_size_; }
+    std::uint64_t size() const { return size_; }
+
+    // Starts over for a new file, keeping the allocation.
+    void reset() {
+        crcs_.clear();
+        crc_ = 0;
+        in_block_ = 0;
+        size_ = 0;
+    }
+
+    void update(const void* data, std::size_t n) {
+        const char* p = static_cast<const char*>(data);
+        size_ += n;
+        while (n > 0) {
+            std::size_t take = std::min<std::size_t>(n, block_size_ - in_block_);
+            crc_ = crc32c(crc_, p, take);
+            in_block_ += take;
+            p += take;
+            n -= take;
+            if (in_block_ == block_size_) {
+                crcs_.push_back(crc_);
+                crc_ = 0;
+                in_block_ = 0;
+            }
+        }
+    }
+
+    // One CRC per block, including a final short one.
+    const std::vector<std::uint32_t>& finish() {
+        if (in_block_ > 0) {
+            crcs_.push_back(crc_);
+            crc_ = 0;
+            in_block_ = 0;
+        }
+        return crcs_;
+    }
+
+private:
+    std::uint32_t block_size_;
+    std::vector<std::uint32_t> crcs_;
+    std::uint32_t crc_ = 0;
+    std::uint32_t in_block_ = 0;
+    std::uint64_t size_ = 0;
+};
+
+// Writes the sidecar for `data_path`. Returns 0 or an errno value.
+inline int write_sidecar(const std::string& data_path, std::uint32_t block_size, std::uint64_t file_size,
+                         const std::vector<std::uint32_t>& crcs) {
+    std::string path = data_path + sidecar_format::kSuffix;
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return errno;
+    sidecar_format::SidecarHeader header{};
+    std::memcpy(header.magic, sidecar_format::kMagic, sizeof(header.magic));
+    header.version = sidecar_format::kVersion;
+    header.block_size = block_size;
+    header.file_size = file_size;
+
+    std::string bytes(reinterpret_cast<const char*>(&header), sizeof(header));
+    bytes.append(reinterpret_cast<const char*>(crcs.data()), crcs.size() * sizeof(std::uint32_t));
+    std::string_view left = bytes;
+    int error = 0;
+    while (!left.empty()) {
+        ssize_t n = ::write(fd, left.data(), left.size());
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            error = errno;
+            break;
+        }
+        left.remove_prefix(static_cast<std::size_t>(n));
+    }
+    if (::close(fd) != 0 && error == 0) error = errno;
+    return error;
+}
+
+enum class VerifyStatus { ok, io_error, bad_sidecar, size_mismatch, bad_blocks };
+
+struct VerifyResult {
+    VerifyStatus status = VerifyStatus::ok;
+    std::uint64_t bytes = 0;
+    std::uint64_t blocks = 0;
+    std::uint32_t block_size = 0;
+    std::vector<std::uint64_t> bad_blocks; // sorted
+};
+
+// Checks `data_path` against its sidecar on `threads` threads.
+inline VerifyResult verify_blocks(const std::string& data_path, unsigned threads) {
+    VerifyResult result;
+    arena::MappedFile data;
+    arena::MappedFile sidecar;
+    if (!data.open(data_path.c_str()) || !sidecar.open((data_path + sidecar_format::kSuffix).c_str())) {
+        result.status = VerifyStatus::io_error;
+        return result;
+    }
+
+    std::string_view side = sidecar.view();
+    sidecar_format::SidecarHeader header;
+    if (side.size() < sizeof(header)) {
+        result.status = VerifyStatus::bad_sidecar;
+        return result;
+    }
+    std::memcpy(&header, side.data(), sizeof(header));
+    std::uint64_t blocks = header.block_size == 0 ? 0 : (header.file_size + header.block_size - 1) / header.block_size;
+    if (std::memcmp(header.magic, sidecar_format::kMagic, sizeof(header.magic)) != 0 ||
+        header.version != sidecar_format::kVersion || header.block_size == 0 ||
+        side.size() != sizeof(header) + blocks * sizeof(std::uint32_t)) {
+        result.status = VerifyStatus::bad_sidecar;
+        return result;
+    }
+    std::string_view bytes = data.view();
+    result.bytes = bytes.size();
+    result.blocks = blocks;
+    result.block_size = header.block_size;
+    if (bytes.size() != header.file_size) {
+        result.status = VerifyStatus::size_mismatch;
+        return result;
+    }
+
+    // Each thread takes runs of blocks big enough to keep the memory
+    // reads sequential and the counter cold.
+    const std::uint64_t run = std::max<std::uint64_t>(1, (std::uint64_t{4} << 20) / header.block_size);
+    std::atomic<std::uint64_t> next{0};
+    std::vector<std::vector<std::uint64_t>> bad(std::max(threads, 1u));
+    auto check = [&](std::vector<std::uint64_t>& mine) {
+        for (std::uint64_t first = next.fetch_add(run); first < blocks; first = next.fetch_add(run)) {
+            std::uint64_t last = std::min(blocks, first + run);
+            for (std::uint64_t i = first; i < last; ++i) {
+                std::uint64_t offset = i * header.block_size;
+                std::size_t size = static_cast<std::size_t>(std::min<std::uint64_t>(header.block_size, bytes.size() - offset));
+                std::uint32_t expected;
+                std::memcpy(&expected, side.data() + sizeof(header) + i * sizeof(expected), sizeof(expected));
+                if (crc32c(0, bytes.data() + offset, size) != expected) mine.push_back(i);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < bad.size(); ++t) pool.emplace_back(check, std::ref(bad[t]));
+    check(bad[0]);
+    for (std::thread& t : pool) t.join();
+
+    for (const std::vector<std::uint64_t>& v : bad) {
+        result.bad_blocks.insert(result.bad_blocks.end(), v.begin(), v.end());
+    }
+    std::sort(result.bad_blocks.begin(), result.bad_blocks.end());
+    if (!result.bad_blocks.empty()) result.status = VerifyStatus::bad_blocks;
+    return result;
+}
+
+} // namespace fileio
@@ -0,0 +1,183 @@
+/*
+    Durable records per second and commit latency for durable_log.hpp.
+
+    Every thread loops on DurableLog::commit() with a fixed-size record
+    (append, then wait until it is durable), for each mode:
+      none        write() only, like HW1_4; nothing is durable
+      per-write   fdatasync() after every record
+      group       one fdatasync() per batch, committing as soon as the
+                  previous sync is done, then lingering up to 2 ms for
+                  batches of up to 4K .. 1M, and 1M with early writeback
+    and prints records/s, average batch (records per sync) and commit
+    latency percentiles. Group commit needs concurrent committers to
+    batch anything, so run it with as many threads as the real writers
+    have.
+
+    The log is written under DIR and removed afterwards. Results depend
+    entirely on the device: on tmpfs fdatasync() is free, on a disk
+    with a volatile cache it can be too good to be true.
+
+    Build: g++ -std=c++17 -O2 -pthread commit_bench.cpp -o commit_bench
+    Usage: commit_bench [-t threads] [-r record_bytes] [-s seconds] [DIR]
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "arena_parse.hpp"
+#include "durable_log.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+    unsigned threads = 16;
+    unsigned record_bytes = 128;
+    double seconds = 1.0;
+    std::string dir = ".";
+};
+
+struct Run {
+    const char* name;
+    fileio::Durability mode;
+    unsigned interval_us;
+    std::size_t batch_bytes;
+    bool early_writeback;
+};
+
+void usage() {
+    std::cerr << "usage: commit_bench [-t threads] [-r record_bytes] [-s seconds] [DIR]\n";
+}
+
+double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    auto i = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1));
+    return sorted[i];
+}
+
+// Returns false after printing an error.
+bool measure(const Config& config, const Run& run) {
+    std::string path = config.dir + "/commit_bench.log";
+    ::unlink(path.c_str());
+
+    std::atomic<std::uint64_t> callbacks{0};
+    fileio::DurableLog::Options options;
+    options.mode = run.mode;
+    options.interval = std::chrono::microseconds(run.interval_us);
+    options.batch_bytes = run.batch_bytes;
+    options.early_writeback = run.early_writeback;
+    options.on_durable = [&](const fileio::DurableLog::Commit&) { callbacks.fetch_add(1, std::memory_order_relaxed); };
+
+    fileio::DurableLog log;
+    if (!log.open(path.c_str(), options)) {
+        perror(path.c_str());
+        return false;
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> error{0};
+    std::vector<std::vector<double>> latencies(config.threads);
+    std::vector<std::thread> threads;
+    auto t0 = Clock::now();
+    for (unsigned t = 0; t < config.threads; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<char> record(config.record_bytes, static_cast<char>('a' + t % 26));
+            std::vector<double>& mine = latencies[t];
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto start = Clock::now();
+                int e = log.commit(record.data(), record.size());
+                if (e != 0) {
+                    error.store(e);
+                    return;
+                }
+                mine.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(config.seconds));
+    stop.store(true);
+    for (std::thread& t : threads) t.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    log.close();
+    ::unlink(path.c_str());
+
+    if (error.load() != 0) {
+        std::cerr << "commit_bench: " << run.name << ": " << std::strerror(error.load()) << "\n";
+        return false;
+    }
+
+    std::vector<double> all;
+    for (const std::vector<double>& v : latencies) all.insert(all.end(), v.begin(), v.end());
+    std::sort(all.begin(), all.end());
+    fileio::DurableLog::Stats stats = log.stats();
+    double per_sync = stats.syncs > 0 ? static_cast<double>(stats.records) / static_cast<double>(stats.syncs) : 0;
+
+    std::cout << std::left << std::setw(20) << run.name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(12) << static_cast<double>(all.size()) / seconds << std::setprecision(1)
+              << std::setw(10) << per_sync << std::setw(10) << percentile(all, 0.5) << std::setw(10)
+              << percentile(all, 0.99) << std::setw(10) << percentile(all, 0.999) << std::setw(11)
+              << callbacks.load() << "\n";
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config config;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool has_value = i + 1 < argc;
+        bool ok = true;
+        if (arg == "-t" && has_value) {
+            ok = arena::parse_int(argv[++i], config.threads, 1u, 4096u) == arena::ParseStatus::ok;
+        } else if (arg == "-r" && has_value) {
+            ok = arena::parse_int(argv[++i], config.record_bytes, 1u, 1u << 24) == arena::ParseStatus::ok;
+        } else if (arg == "-s" && has_value) {
+            unsigned seconds = 0;
+            ok = arena::parse_int(argv[++i], seconds, 1u, 3600u) == arena::ParseStatus::ok;
+            config.seconds = seconds;
+        } else if (!arg.empty() && arg[0] != '-') {
+            config.dir = std::string(arg);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            usage();
+            return 1;
+        }
+    }
+
+    const Run runs[] = {
+        {"none", fileio::Durability::none, 0, 0, false},
+        {"per-write", fileio::Durability::per_write, 0, 0, false},
+        {"group", fileio::Durability::group, 0, 256 << 10, false},
+        {"group 2ms 4K", fileio::Durability::group, 2000, 4 << 10, false},
+        {"group 2ms 16K", fileio::Durability::group, 2000, 16 << 10, false},
+        {"group 2ms 64K", fileio::Durability::group, 2000, 64 << 10, false},
+        {"group 2ms 256K", fileio::Durability::group, 2000, 256 << 10, false},
+        {"group 2ms 1M", fileio::Durability::group, 2000, 1 << 20, false},
+        {"group 2ms 1M early", fileio::Durability::group, 2000, 1 << 20, true},
+    };
+
+    std::cout << config.threads << " threads, " << config.record_bytes << "-byte records, " << config.seconds
+              << " s per mode, in " << config.dir << "\n\n";
+    std::cout << std::left << std::setw(20) << "mode" << std::right << std::setw(12) << "records/s" << std::setw(10)
+              << "batch" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::setw(10) << "p99.9 us"
+              << std::setw(11) << "callbacks" << "\n";
+    for (const Run& run : runs) {
+        if (!measure(config, run)) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+/*
+    Compressed vs. plain writes, through compressed_file.hpp.
+
+    Produces SIZE MB of data, 1 MiB at a time, and writes it
+    1. raw with write(), as HW1_4 does,
+    2. through CompressingWriter (producer -> compression workers ->
+       writer thread),
+    then decompresses the compressed file on all threads and checks it
+    against the data. Prints MB/s of raw data for every step and the
+    compression ratio.
+
+    The data comes from data_gen.hpp: arena-log-like text by default,
+    or any other -d kind (-a is -d a, HW1_4's buffer of 'A's). It is
+    regenerated from its position, so nothing is held in memory except
+    the decompressed copy that is checked.
+
+    Build: g++ -std=c++17 -O2 -pthread compress_bench.cpp -o compress_bench
+    Usage: compress_bench [-m MB] [-b block_KiB] [-w workers] [-a]
+                          [-d random|text|a|PERCENT] [DIR]
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "arena_parse.hpp"
+#include "compressed_file.hpp"
+#include "data_gen.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kChunk = 1 << 20;
+
+struct Config {
+    unsigned megabytes = 256;
+    unsigned block_kib = 128;
+    unsigned workers = 0;
+    fileio::DataSpec data{fileio::DataKind::text};
+    std::string dir = ".";
+};
+
+void usage() {
+    std::cerr << "usage: compress_bench [-m MB] [-b block_KiB] [-w workers] [-a]\n"
+                 "                      [-d random|text|a|PERCENT] [DIR]\n";
+}
+
+double seconds_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+int write_all(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno;
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config config;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool has_value = i + 1 < argc;
+        bool ok = true;
+        if (arg == "-m" && has_value) {
+            ok = arena::parse_int(argv[++i], config.megabytes, 1u, 1u << 20) == arena::ParseStatus::ok;
+        } else if (arg == "-b" && has_value) {
+            ok = arena::parse_int(argv[++i], config.block_kib, 1u, 1u << 20) == arena::ParseStatus::ok;
+        } else if (arg == "-w" && has_value) {
+            ok = arena::parse_int(argv[++i], config.workers, 1u, 1024u) == arena::ParseStatus::ok;
+        } else if (arg == "-a") {
+            config.data.kind = fileio::DataKind::fill_a;
+        } else if (arg == "-d" && has_value) {
+            ok = fileio::parse_data_spec(argv[++i], config.data);
+        } else if (!arg.empty() && arg[0] != '-') {
+            config.dir = std::string(arg);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            usage();
+            return 1;
+        }
+    }
+
+    std::uint64_t chunks = config.megabytes;
+    double megabytes = static_cast<double>(chunks * kChunk) / 1e6;
+    fileio::DataGenerator data(config.data);
+    std::vector<char> chunk(kChunk);
+    std::string raw_path = config.dir + "/compress_bench.raw";
+    std::string lz_path = config.dir + "/compress_bench.oalz";
+
+    // Generating the data alone, to separate it from the write paths.
+    auto t0 = Clock::now();
+    for (std::uint64_t i = 0; i < chunks; ++i) data.fill(i * kChunk, chunk.data(), kChunk);
+    double generate_seconds = seconds_since(t0);
+
+    t0 = Clock::now();
+    int fd = ::open(raw_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror(raw_path.c_str());
+        return 1;
+    }
+    for (std::uint64_t i = 0; i < chunks; ++i) {
+        data.fill(i * kChunk, chunk.data(), kChunk);
+        if (int e = write_all(fd, chunk.data(), kChunk); e != 0) {
+            errno = e;
+            perror(raw_path.c_str());
+            return 1;
+        }
+    }
+    ::close(fd);
+    double raw_seconds = seconds_since(t0);
+
+    fileio::CompressingWriter::Options options;
+    options.block_size = std::size_t{config.block_kib} * 1024;
+    options.workers = config.workers;
+    fileio::CompressingWriter writer;
+    t0 = Clock::now();
+    if (!writer.open(lz_path.c_str(), options)) {
+        perror(lz_path.c_str());
+        return 1;
+    }
+    for (std::uint64_t i = 0; i < chunks; ++i) {
+        data.fill(i * kChunk, chunk.data(), kChunk);
+        writer.write(chunk.data(), kChunk);
+    }
+    if (int e = writer.close(); e != 0) {
+        errno = e;
+        perror(lz_path.c_str());
+        return 1;
+    }
+    double lz_seconds = seconds_since(t0);
+    const fileio::CompressingWriter::Stats& stats = writer.stats();
+
+    fileio::CompressedFile file;
+    if (file.open(lz_path.c_str()) != fileio::FrameStatus::ok) {
+        std::cerr << "compress_bench: " << lz_path << " does not read back\n";
+        return 1;
+    }
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<char> restored(file.raw_size());
+    t0 = Clock::now();
+    fileio::FrameStatus status = file.read_all(restored.data(), threads);
+    double read_seconds = seconds_since(t0);
+    bool same = status == fileio::FrameStatus::ok && restored.size() == chunks * kChunk;
+    for (std::uint64_t i = 0; same && i < chunks; ++i) {
+        data.fill(i * kChunk, chunk.data(), kChunk);
+        same = std::memcmp(chunk.data(), restored.data() + i * kChunk, kChunk) == 0;
+    }
+    ::unlink(raw_path.c_str());
+    ::unlink(lz_path.c_str());
+    if (!same) {
+        std::cerr << "compress_bench: decompressed data does not match\n";
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(1) << megabytes << " MB of "
+              << fileio::describe(config.data) << " data, " << config.block_kib << " KiB blocks, "
+              << stats.blocks << " blocks (" << stats.stored_blocks << " stored raw)\n";
+    std::cout << "generate only         " << std::setw(9) << megabytes / generate_seconds << " MB/s\n";
+    std::cout << "raw write()           " << std::setw(9) << megabytes / raw_seconds << " MB/s, "
+              << megabytes << " MB on disk\n";
+    std::cout << "compressed pipeline   " << std::setw(9) << megabytes / lz_seconds << " MB/s, "
+              << static_cast<double>(stats.file_bytes) / 1e6 << " MB on disk, ratio " << std::setprecision(2)
+              << stats.ratio() << "\n";
+    std::cout << "parallel decompress   " << std::setprecision(1) << std::setw(9) << megabytes / read_seconds
+              << " MB/s on " << threads << " thread(s), verified\n";
+    return 0;
+}
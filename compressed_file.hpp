@@ -0,0 +1,409 @@
+/*
+    Compressed files written through a producer -> compressors -> writer
+    pipeline, and read back with every block decompressed in parallel.
+
+    File layout (little-endian):
+
+        FileHeader     magic "OALZFRM1", version, block size
+        blocks         BlockHeader {raw_size, stored_size} + payload;
+                       stored_size has kStoredRaw set when the block
+                       did not compress and is kept as is
+        index          one uint64 file offset per block header
+        Footer         index offset, block count, total raw size,
+                       magic "OALZIDX1"
+
+    Every block is compressed on its own (lz_codec.hpp) and every block
+    but the last holds exactly block_size raw bytes. A reader can
+    therefore find each block through the index and its place in the
+    output through its number, and decompress all of them at once.
+
+    CompressingWriter runs the pipeline. write() copies into the block
+    being filled. A full block goes through an MPMC queue to the
+    compression workers, and the producer moves on to the next one. A
+    writer thread puts the compressed blocks on disk in order. Blocks
+    rotate through a fixed set of slots (two per worker plus two), so
+    one block is being filled while others are compressed and written,
+    and a producer that outruns the disk waits for a free slot instead
+    of buffering without bound.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "arena_parse.hpp"
+#include "lz_codec.hpp"
+#include "mpmc_queue.hpp"
+
+namespace fileio {
+
+namespace frame_format {
+
+constexpr char kMagic[8] = {'O', 'A', 'L', 'Z', 'F', 'R', 'M', '1'};
+constexpr char kIndexMagic[8] = {'O', 'A', 'L', 'Z', 'I', 'D', 'X', '1'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kStoredRaw = 0x80000000u;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t block_size;
+};
+
+struct BlockHeader {
+    std::uint32_t raw_size;
+    std::uint32_t stored_size; // payload bytes, | kStoredRaw if not compressed
+};
+
+struct Footer {
+    std::uint64_t index_offset;
+    std::uint64_t block_count;
+    std::uint64_t raw_size;
+    char magic[8];
+};
+
+static_assert(sizeof(FileHeader) == 16 && sizeof(BlockHeader) == 8 && sizeof(Footer) == 32);
+
+} // namespace frame_format
+
+class CompressingWriter {
+public:
+    struct Options {
+        std::size_t block_size = 128 * 1024;
+        unsigned workers = 0; // 0: one per core, minus the producer and writer
+    };
+
+    struct Stats {
+        std::uint64_t raw_bytes = 0;
+        std::uint64_t file_bytes = 0;
+        std::uint64_t blocks = 0;
+        std::uint64_t stored_blocks = 0; // kept uncompressed
+
+        double ratio() const { return file_bytes > 0 ? static_cast<double>(raw_bytes) / file_bytes : 0; }
+    };
+
+    CompressingWriter() = default;
+    ~CompressingWriter() { close(); }
+
+    CompressingWriter(const CompressingWriter&) = delete;
+    CompressingWriter& operator=(const CompressingWriter&) = delete;
+
+    // Creates or truncates `path`. Returns false with errno set.
+    bool open(const char* path, const Options& options) {
+        close();
+        fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) return false;
+
+        block_size_ = std::min<std::size_t>(std::max<std::size_t>(options.block_size, 1), frame_format::kStoredRaw - 1);
+        unsigned workers = options.workers;
+        if (workers == 0) {
+            unsigned cores = std::thread::hardware_concurrency();
+            workers = cores > 2 ? cores - 2 : 1;
+        }
+        std::size_t slot_count = 2 * std::size_t{workers} + 2;
+        slots_ = std::make_unique<Slot[]>(slot_count);
+        slot_count_ = slot_count;
+        for (std::size_t i = 0; i < slot_count; ++i) {
+            slots_[i].raw.resize(block_size_);
+            slots_[i].packed.resize(lz_bound(block_size_));
+        }
+        queue_ = std::make_unique<MpmcQueue<std::uint64_t>>(slot_count);
+        index_.clear();
+        stats_ = Stats{};
+        next_block_ = 0;
+        filling_ = nullptr;
+        error_ = 0;
+        end_block_.store(~std::uint64_t{0});
+        stopping_.store(false);
+
+        frame_format::FileHeader header{};
+        std::memcpy(header.magic, frame_format::kMagic, sizeof(header.magic));
+        header.version = frame_format::kVersion;
+        header.block_size = static_cast<std::uint32_t>(block_size_);
+        error_ = write_all(&header, sizeof(header));
+        file_offset_ = sizeof(header);
+
+        for (unsigned i = 0; i < workers; ++i) {
+            workers_.emplace_back([this] { compress_loop(); });
+        }
+        writer_ = std::thread([this] { write_loop(); });
+        return true;
+    }
+
+    // Producer side; one thread only.
+    void write(const void* data, std::size_t size) {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0) {
+            if (filling_ == nullptr) start_block();
+            std::size_t n = std::min(size, block_size_ - filling_->raw_size);
+            std::memcpy(filling_->raw.data() + filling_->raw_size, p, n);
+            filling_->raw_size += n;
+            p += n;
+            size -= n;
+            if (filling_->raw_size == block_size_) finish_block();
+        }
+    }
+
+    // Writes out the last block, the index and the footer, and closes
+    // the file. Returns 0 or the first errno. Idempotent.
+    int close() {
+        if (fd_ < 0) return error_;
+        if (filling_ != nullptr) finish_block();
+        end_block_.store(next_block_);
+        stopping_.store(true);
+        work_ready_.notify_all();
+        block_done_.notify_all();
+        for (std::thread& t : workers_) t.join();
+        workers_.clear();
+        writer_.join();
+
+        if (error_ == 0) {
+            frame_format::Footer footer{};
+            footer.index_offset = file_offset_;
+            footer.block_count = index_.size();
+            footer.raw_size = stats_.raw_bytes;
+            std::memcpy(footer.magic, frame_format::kIndexMagic, sizeof(footer.magic));
+            error_ = write_all(index_.data(), index_.size() * sizeof(std::uint64_t));
+            if (error_ == 0) error_ = write_all(&footer, sizeof(footer));
+            file_offset_ += index_.size() * sizeof(std::uint64_t) + sizeof(footer);
+        }
+        if (::close(fd_) != 0 && error_ == 0) error_ = errno;
+        fd_ = -1;
+        stats_.file_bytes = file_offset_;
+        return error_;
+    }
+
+    // Complete after close().
+    const Stats& stats() const { return stats_; }
+
+private:
+    enum SlotState : int { kFree, kQueued, kCompressed };
+
+    struct Slot {
+        std::atomic<int> state{kFree};
+        std::vector<char> raw;
+        std::size_t raw_size = 0;
+        std::vector<char> packed;
+        std::uint32_t stored_size = 0;
+    };
+
+    Slot& slot(std::uint64_t block) { return slots_[block % slot_count_]; }
+
+    void start_block() {
+        Slot& s = slot(next_block_);
+        slot_free_.wait([&] { return s.state.load(std::memory_order_acquire) == kFree; });
+        s.raw_size = 0;
+        filling_ = &s;
+    }
+
+    void finish_block() {
+        filling_->state.store(kQueued, std::memory_order_relaxed);
+        std::uint64_t block = next_block_++;
+        // There are as many queue cells as slots, so this cannot fail.
+        queue_->try_push(block);
+        work_ready_.notify_one();
+        filling_ = nullptr;
+    }
+
+    void compress_loop() {
+        std::uint64_t block = 0;
+        while (true) {
+            if (queue_->try_pop(block)) {
+                Slot& s = slot(block);
+                std::size_t packed = lz_compress(s.raw.data(), s.raw_size, s.packed.data());
+                s.stored_size = packed < s.raw_size ? static_cast<std::uint32_t>(packed)
+                                                    : static_cast<std::uint32_t>(s.raw_size) | frame_format::kStoredRaw;
+                s.state.store(kCompressed, std::memory_order_release);
+                block_done_.notify_one();
+                continue;
+            }
+            if (stopping_.load()) return;
+            work_ready_.wait([&] { return queue_->size_approx() > 0 || stopping_.load(); });
+        }
+    }
+
+    void write_loop() {
+        for (std::uint64_t block = 0;; ++block) {
+            Slot& s = slot(block);
+            block_done_.wait([&] {
+                return s.state.load(std::memory_order_acquire) == kCompressed || block >= end_block_.load();
+            });
+            if (s.state.load(std::memory_order_acquire) != kCompressed) return;
+
+            bool stored = (s.stored_size & frame_format::kStoredRaw) != 0;
+            std::size_t payload = s.stored_size & ~frame_format::kStoredRaw;
+            frame_format::BlockHeader header{static_cast<std::uint32_t>(s.raw_size), s.stored_size};
+            iovec iov[2] = {{&header, sizeof(header)}, {stored ? s.raw.data() : s.packed.data(), payload}};
+            if (error_ == 0) error_ = writev_all(iov, 2);
+            index_.push_back(file_offset_);
+            file_offset_ += sizeof(header) + payload;
+            stats_.raw_bytes += s.raw_size;
+            ++stats_.blocks;
+            if (stored) ++stats_.stored_blocks;
+
+            s.state.store(kFree, std::memory_order_release);
+            slot_free_.notify_one();
+        }
+    }
+
+    int write_all(const void* data, std::size_t size) {
+        iovec iov{const_cast<void*>(data), size};
+        return writev_all(&iov, 1);
+    }
+
+    // Returns 0 or an errno value.
+    int writev_all(iovec* iov, int count) {
+        while (count > 0) {
+            ssize_t n = ::writev(fd_, iov, count);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return errno;
+            }
+            auto left = static_cast<std::size_t>(n);
+            while (count > 0 && left >= iov->iov_len) {
+                left -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+                iov->iov_len -= left;
+            }
+        }
+        return 0;
+    }
+
+    int fd_ = -1;
+    std::size_t block_size_ = 0;
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t slot_count_ = 0;
+    std::unique_ptr<MpmcQueue<std::uint64_t>> queue_;
+    std::vector<std::thread> workers_;
+    std::thread writer_;
+    Parking work_ready_;
+    Parking block_done_;
+    Parking slot_free_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<std::uint64_t> end_block_{0}; // blocks produced, once close() starts
+
+    // Producer only.
+    std::uint64_t next_block_ = 0;
+    Slot* filling_ = nullptr;
+
+    // Writer thread only until it is joined.
+    std::vector<std::uint64_t> index_;
+    std::uint64_t file_offset_ = 0;
+    Stats stats_;
+    int error_ = 0;
+};
+
+enum class FrameStatus { ok, io_error, bad_format, corrupt };
+
+// A compressed file mapped for reading. open() checks the header,
+// footer and index; read_all() checks every block as it decodes it.
+class CompressedFile {
+public:
+    FrameStatus open(const char* path) {
+        blocks_ = 0;
+        if (!file_.open(path)) return FrameStatus::io_error;
+        std::string_view data = file_.view();
+
+        frame_format::FileHeader header;
+        frame_format::Footer footer;
+        if (data.size() < sizeof(header) + sizeof(footer)) return FrameStatus::bad_format;
+        std::memcpy(&header, data.data(), sizeof(header));
+        std::memcpy(&footer, data.data() + data.size() - sizeof(footer), sizeof(footer));
+        if (std::memcmp(header.magic, frame_format::kMagic, sizeof(header.magic)) != 0 ||
+            header.version != frame_format::kVersion || header.block_size == 0 ||
+            std::memcmp(footer.magic, frame_format::kIndexMagic, sizeof(footer.magic)) != 0) {
+            return FrameStatus::bad_format;
+        }
+        // Every bound is checked by subtraction or division, so no
+        // footer value can wrap it.
+        std::uint64_t body = data.size() - sizeof(footer);
+        if (footer.block_count > data.size() / sizeof(frame_format::BlockHeader) ||
+            footer.block_count > body / sizeof(std::uint64_t)) {
+            return FrameStatus::corrupt;
+        }
+        std::uint64_t index_bytes = footer.block_count * sizeof(std::uint64_t);
+        std::uint64_t raw_blocks = footer.raw_size / header.block_size + (footer.raw_size % header.block_size != 0);
+        if (footer.index_offset < sizeof(header) || footer.index_offset != body - index_bytes ||
+            raw_blocks > footer.block_count) {
+            return FrameStatus::corrupt;
+        }
+        block_size_ = header.block_size;
+        raw_size_ = footer.raw_size;
+        index_offset_ = footer.index_offset;
+        blocks_ = footer.block_count;
+        return FrameStatus::ok;
+    }
+
+    std::uint64_t raw_size() const { return raw_size_; }
+    std::uint64_t blocks() const { return blocks_; }
+    std::uint32_t block_size() const { return block_size_; }
+
+    // Decompresses the whole file into out[0, raw_size()) on `threads`
+    // threads, each taking the next undone block.
+    FrameStatus read_all(char* out, unsigned threads) const {
+        std::atomic<std::uint64_t> next{0};
+        std::atomic<bool> corrupt{false};
+        auto run = [&] {
+            for (std::uint64_t i = next.fetch_add(1); i < blocks_ && !corrupt.load(std::memory_order_relaxed);
+                 i = next.fetch_add(1)) {
+                if (!read_block(i, out)) corrupt.store(true);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) pool.emplace_back(run);
+        run();
+        for (std::thread& t : pool) t.join();
+        return corrupt.load() ? FrameStatus::corrupt : FrameStatus::ok;
+    }
+
+private:
+    bool read_block(std::uint64_t i, char* out) const {
+        std::string_view data = file_.view();
+        std::uint64_t offset;
+        std::memcpy(&offset, data.data() + index_offset_ + i * sizeof(offset), sizeof(offset));
+        frame_format::BlockHeader header;
+        if (offset < sizeof(frame_format::FileHeader) || offset > index_offset_ ||
+            index_offset_ - offset < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, data.data() + offset, sizeof(header));
+        std::size_t payload = header.stored_size & ~frame_format::kStoredRaw;
+        std::uint64_t raw_offset = i * block_size_;
+        if (raw_offset >= raw_size_) return false;
+        std::uint64_t expected = std::min<std::uint64_t>(block_size_, raw_size_ - raw_offset);
+        if (payload > index_offset_ - offset - sizeof(header) || header.raw_size != expected) return false;
+
+        const char* src = data.data() + offset + sizeof(header);
+        char* dst = out + raw_offset;
+        if ((header.stored_size & frame_format::kStoredRaw) != 0) {
+            if (payload != expected) return false;
+            std::memcpy(dst, src, payload);
+            return true;
+        }
+        return lz_decompress(src, payload, dst, expected) == static_cast<std::ptrdiff_t>(expected);
+    }
+
+    arena::MappedFile file_;
+    std::uint32_t block_size_ = 0;
+    std::uint64_t raw_size_ = 0;
+    std::uint64_t index_offset_ = 0;
+    std::uint64_t blocks_ = 0;
+};
+
+} // namespace fileio
@@ -0,0 +1,174 @@
+/*
+    Benchmark for the counter patterns from HW1_3 under threads.
+
+    For 1 to 64 threads, every thread does the same number of
+    increments on:
+      - a plain static int (modelled as a relaxed load + store, which is
+        what the racy ++ compiles to, without the undefined behavior;
+        it loses updates)
+      - a std::atomic static (one contended cache line)
+      - a thread_local int (no sharing, no total)
+      - ShardedCounter (per-thread padded slots, summed on read)
+    It also measures what the guard on a function-local static with a
+    dynamic initializer costs per call.
+
+    Build: g++ -std=c++17 -O2 -pthread counter_bench.cpp -o counter_bench
+*/
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sharded_counter.hpp"
+
+namespace {
+
+constexpr std::int64_t kIncrementsPerThread = 1'000'000;
+
+std::atomic<std::int64_t> g_plain{0};   // see file comment
+std::atomic<std::int64_t> g_atomic{0};
+thread_local std::int64_t t_local = 0;
+
+struct Result {
+    double ns_per_op;
+    std::int64_t total;
+};
+
+template <typename Body>
+double run_threads(int threads, Body body) {
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            body();
+        });
+    }
+    while (ready.load() != threads) {
+        std::this_thread::yield();
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& th : pool) {
+        th.join();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    return ns / static_cast<double>(kIncrementsPerThread * threads);
+}
+
+Result bench_plain(int threads) {
+    g_plain.store(0);
+    double ns = run_threads(threads, [] {
+        for (std::int64_t i = 0; i < kIncrementsPerThread; ++i) {
+            g_plain.store(g_plain.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    });
+    return {ns, g_plain.load()};
+}
+
+Result bench_atomic(int threads) {
+    g_atomic.store(0);
+    double ns = run_threads(threads, [] {
+        for (std::int64_t i = 0; i < kIncrementsPerThread; ++i) {
+            g_atomic.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    return {ns, g_atomic.load()};
+}
+
+Result bench_thread_local(int threads) {
+    std::atomic<std::int64_t> total{0};
+    double ns = run_threads(threads, [&] {
+        t_local = 0;
+        for (std::int64_t i = 0; i < kIncrementsPerThread; ++i) {
+            // compiler barrier so the loop isn't folded into one add
+            asm volatile("" : : : "memory");
+            ++t_local;
+        }
+        total.fetch_add(t_local);
+    });
+    return {ns, total.load()};
+}
+
+Result bench_sharded(int threads) {
+    auto counter = std::make_unique<ShardedCounter>(); // fresh slots per run
+    ShardedCounter* c = counter.get();
+    double ns = run_threads(threads, [c] {
+        for (std::int64_t i = 0; i < kIncrementsPerThread; ++i) {
+            c->add();
+        }
+    });
+    return {ns, c->read()};
+}
+
+// Dynamic initializer, so every call checks the init guard.
+std::int64_t make_start() {
+    return static_cast<std::int64_t>(std::chrono::steady_clock::now().time_since_epoch().count() & 1);
+}
+
+[[gnu::noinline]] std::int64_t with_guard() {
+    static std::int64_t start = make_start();
+    return start;
+}
+
+std::int64_t g_no_guard_start = 0; // constant-initialized
+
+[[gnu::noinline]] std::int64_t without_guard() {
+    return g_no_guard_start;
+}
+
+template <typename Fn>
+double ns_per_call(int threads, Fn fn) {
+    return run_threads(threads, [fn] {
+        std::int64_t sink = 0;
+        for (std::int64_t i = 0; i < kIncrementsPerThread; ++i) {
+            sink += fn();
+        }
+        asm volatile("" : : "r"(sink));
+    });
+}
+
+void print_row(int threads, const Result& r, const char* name) {
+    std::int64_t expected = kIncrementsPerThread * threads;
+    std::cout << std::setw(8) << threads << "  " << std::left << std::setw(14) << name
+              << std::right << std::fixed << std::setprecision(2) << std::setw(10) << r.ns_per_op
+              << std::setw(10) << std::setprecision(1)
+              << 100.0 * static_cast<double>(expected - r.total) / static_cast<double>(expected)
+              << "%\n";
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Increments per thread: " << kIncrementsPerThread << "\n\n";
+    std::cout << std::setw(8) << "threads" << "  " << std::left << std::setw(14) << "counter"
+              << std::right << std::setw(10) << "ns/op" << std::setw(11) << "lost" << "\n";
+    std::cout << std::string(43, '-') << "\n";
+
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        print_row(threads, bench_plain(threads), "plain static");
+        print_row(threads, bench_atomic(threads), "atomic static");
+        print_row(threads, bench_thread_local(threads), "thread_local");
+        print_row(threads, bench_sharded(threads), "sharded");
+    }
+
+    std::cout << "\nFunction-local static init guard (ns/call)\n";
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "with guard"
+              << std::setw(14) << "no guard" << "\n";
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(2)
+                  << std::setw(14) << ns_per_call(threads, with_guard)
+                  << std::setw(14) << ns_per_call(threads, without_guard) << "\n";
+    }
+    return 0;
+}
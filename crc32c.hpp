@@ -0,0 +1,202 @@
+/*
+    CRC32C (Castagnoli), the checksum iSCSI, ext4 and most storage
+    formats use, because x86 computes it in hardware.
+
+    The SSE4.2 crc32 instruction takes 8 bytes per call but has a
+    latency of 3 cycles, so one dependency chain leaves two thirds of
+    the unit idle. The hardware kernel therefore splits each stretch of
+    3 x 8 KiB (then 3 x 256 bytes) into three streams, runs three
+    independent chains, and joins them by shifting the first CRCs past
+    the bytes of the later streams. Shifting a CRC by a fixed number of
+    zero bytes is linear, so it is a lookup in four 256-entry tables
+    built once at startup. This is Mark Adler's construction.
+
+    Without SSE4.2 (checked at run time, so the build needs no -m flag)
+    or off x86-64, a slicing-by-8 table kernel is used.
+
+    crc32c(crc, data, n) continues a checksum: start from 0, and feeding
+    a buffer in pieces gives the same result as feeding it in one call.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace fileio {
+
+namespace crc32c_detail {
+
+constexpr std::uint32_t kPoly = 0x82f63b78u; // reflected Castagnoli polynomial
+constexpr std::size_t kLong = 8192;
+constexpr std::size_t kShort = 256;
+
+// 32x32 GF(2) matrices, stored as the image of each bit.
+inline std::uint32_t gf2_times(const std::uint32_t* mat, std::uint32_t vec) {
+    std::uint32_t sum = 0;
+    for (; vec != 0; vec >>= 1, ++mat) {
+        if (vec & 1) sum ^= *mat;
+    }
+    return sum;
+}
+
+inline void gf2_square(std::uint32_t* square, const std::uint32_t* mat) {
+    for (int n = 0; n < 32; ++n) square[n] = gf2_times(mat, mat[n]);
+}
+
+struct Tables {
+    std::uint32_t slice[8][256]; // slicing-by-8
+    std::uint32_t shift_long[4][256];  // CRC register advanced past kLong zero bytes
+    std::uint32_t shift_short[4][256]; // ... past kShort zero bytes
+
+    Tables() {
+        for (std::uint32_t n = 0; n < 256; ++n) {
+            std::uint32_t crc = n;
+            for (int k = 0; k < 8; ++k) crc = crc & 1 ? (crc >> 1) ^ kPoly : crc >> 1;
+            slice[0][n] = crc;
+        }
+        for (std::uint32_t n = 0; n < 256; ++n) {
+            for (int k = 1; k < 8; ++k) {
+                slice[k][n] = (slice[k - 1][n] >> 8) ^ slice[0][slice[k - 1][n] & 0xff];
+            }
+        }
+        build_shift(shift_long, kLong);
+        build_shift(shift_short, kShort);
+    }
+
+    // `bytes` must be a power of two.
+    static void build_shift(std::uint32_t table[4][256], std::size_t bytes) {
+        std::uint32_t odd[32];
+        std::uint32_t even[32];
+        odd[0] = kPoly; // one zero bit
+        for (int n = 1; n < 32; ++n) odd[n] = 1u << (n - 1);
+        gf2_square(even, odd); // two zero bits
+        gf2_square(odd, even); // four
+        const std::uint32_t* op = nullptr;
+        while (true) {
+            gf2_square(even, odd); // 8, 32, 128, ... bits
+            bytes >>= 1;
+            if (bytes == 0) {
+                op = even;
+                break;
+            }
+            gf2_square(odd, even); // 16, 64, 256, ... bits
+            bytes >>= 1;
+            if (bytes == 0) {
+                op = odd;
+                break;
+            }
+        }
+        for (std::uint32_t n = 0; n < 256; ++n) {
+            for (int k = 0; k < 4; ++k) table[k][n] = gf2_times(op, n << (8 * k));
+        }
+    }
+};
+
+inline const Tables& tables() {
+    static const Tables t;
+    return t;
+}
+
+inline std::uint32_t shift(const std::uint32_t table[4][256], std::uint32_t crc) {
+    return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^ table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+}
+
+} // namespace crc32c_detail
+
+// Table-driven kernel, any CPU.
+inline std::uint32_t crc32c_sw(std::uint32_t crc, const void* data, std::size_t n) {
+    const crc32c_detail::Tables& t = crc32c_detail::tables();
+    const auto* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (; n >= 8; n -= 8, p += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        word ^= crc;
+        crc = t.slice[7][word & 0xff] ^ t.slice[6][(word >> 8) & 0xff] ^ t.slice[5][(word >> 16) & 0xff] ^
+              t.slice[4][(word >> 24) & 0xff] ^ t.slice[3][(word >> 32) & 0xff] ^
+              t.slice[2][(word >> 40) & 0xff] ^ t.slice[1][(word >> 48) & 0xff] ^ t.slice[0][word >> 56];
+    }
+    for (; n > 0; --n, ++p) crc = (crc >> 8) ^ t.slice[0][(crc ^ *p) & 0xff];
+    return ~crc;
+}
+
+#if defined(__x86_64__)
+
+inline bool crc32c_hw_available() {
+    static const bool available = __builtin_cpu_supports("sse4.2");
+    return available;
+}
+
+namespace crc32c_detail {
+
+// Consumes whole groups of three consecutive `stretch`-byte runs from
+// p, one crc32 chain per run, and joins the chains.
+__attribute__((target("sse4.2"))) inline std::uint64_t three_way(std::uint64_t crc0, const unsigned char*& p,
+                                                                  std::size_t& n, std::size_t stretch,
+                                                                  const std::uint32_t table[4][256]) {
+    while (n >= 3 * stretch) {
+        std::uint64_t crc1 = 0;
+        std::uint64_t crc2 = 0;
+        const unsigned char* end = p + stretch;
+        do {
+            std::uint64_t w0, w1, w2;
+            std::memcpy(&w0, p, 8);
+            std::memcpy(&w1, p + stretch, 8);
+            std::memcpy(&w2, p + 2 * stretch, 8);
+            crc0 = _mm_crc32_u64(crc0, w0);
+            crc1 = _mm_crc32_u64(crc1, w1);
+            crc2 = _mm_crc32_u64(crc2, w2);
+            p += 8;
+        } while (p < end);
+        crc0 = shift(table, static_cast<std::uint32_t>(crc0)) ^ crc1;
+        crc0 = shift(table, static_cast<std::uint32_t>(crc0)) ^ crc2;
+        p += 2 * stretch;
+        n -= 3 * stretch;
+    }
+    return crc0;
+}
+
+} // namespace crc32c_detail
+
+// SSE4.2 kernel; only call it when crc32c_hw_available().
+__attribute__((target("sse4.2"))) inline std::uint32_t crc32c_hw(std::uint32_t crc, const void* data,
+                                                                  std::size_t n) {
+    using namespace crc32c_detail;
+    const Tables& t = tables();
+    const auto* p = static_cast<const unsigned char*>(data);
+    std::uint64_t crc0 = ~crc;
+
+    for (; n > 0 && reinterpret_cast<std::uintptr_t>(p) % 8 != 0; --n, ++p) {
+        crc0 = _mm_crc32_u8(static_cast<std::uint32_t>(crc0), *p);
+    }
+
+    crc0 = three_way(crc0, p, n, kLong, t.shift_long);
+    crc0 = three_way(crc0, p, n, kShort, t.shift_short);
+
+    for (; n >= 8; n -= 8, p += 8) {
+        std::uint64_t w;
+        std::memcpy(&w, p, 8);
+        crc0 = _mm_crc32_u64(crc0, w);
+    }
+    for (; n > 0; --n, ++p) crc0 = _mm_crc32_u8(static_cast<std::uint32_t>(crc0), *p);
+    return ~static_cast<std::uint32_t>(crc0);
+}
+
+inline std::uint32_t crc32c(std::uint32_t crc, const void* data, std::size_t n) {
+    return crc32c_hw_available() ? crc32c_hw(crc, data, n) : crc32c_sw(crc, data, n);
+}
+
+#else
+
+inline bool crc32c_hw_available() { return false; }
+
+inline std::uint32_t crc32c(std::uint32_t crc, const void* data, std::size_t n) { return crc32c_sw(crc, data, n); }
+
+#endif
+
+} // namespace fileio
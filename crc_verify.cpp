@@ -0,0 +1,91 @@
+/*
+    Checks files against the CRC32C sidecars written next to them (see
+    block_checksums.hpp), e.g. by multi_writer -c.
+
+    Each file is mapped and its blocks are checked on all threads.
+    Prints every damaged block with its byte range, then the total
+    checked and the rate. Exits 1 if any file fails.
+
+    Build: g++ -std=c++17 -O2 -pthread crc_verify.cpp -o crc_verify
+    Usage: crc_verify [-j threads] file1 [file2 ...]
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "arena_parse.hpp"
+#include "block_checksums.hpp"
+
+namespace {
+
+void usage() {
+    std::cerr << "usage: crc_verify [-j threads] file1 [file2 ...]\n";
+}
+
+const char* describe(fileio::VerifyStatus status) {
+    switch (status) {
+    case fileio::VerifyStatus::ok:
+        return "ok";
+    case fileio::VerifyStatus::io_error:
+        return "cannot open file or sidecar";
+    case fileio::VerifyStatus::bad_sidecar:
+        return "sidecar is not valid";
+    case fileio::VerifyStatus::size_mismatch:
+        return "file size differs from the sidecar";
+    case fileio::VerifyStatus::bad_blocks:
+        return "checksum mismatch";
+    }
+    return "?";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            if (arena::parse_int(argv[++i], threads, 1u, 1024u) != arena::ParseStatus::ok) {
+                usage();
+                return 1;
+            }
+        } else {
+            paths.emplace_back(arg);
+        }
+    }
+    if (paths.empty()) {
+        usage();
+        return 1;
+    }
+
+    std::uint64_t bytes = 0;
+    std::uint64_t failed = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (const std::string& path : paths) {
+        fileio::VerifyResult result = fileio::verify_blocks(path, threads);
+        bytes += result.bytes;
+        if (result.status == fileio::VerifyStatus::ok) continue;
+        ++failed;
+        std::cout << path << ": " << describe(result.status) << "\n";
+        for (std::uint64_t block : result.bad_blocks) {
+            std::uint64_t first = block * result.block_size;
+            std::uint64_t end = std::min(first + result.block_size, result.bytes);
+            std::cout << "  block " << block << " (bytes " << first << ".." << end << ")\n";
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << paths.size() - failed << "/" << paths.size() << " files ok, " << std::fixed << std::setprecision(1)
+              << static_cast<double>(bytes) / 1e6 << " MB checked in " << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(2) << (seconds > 0 ? static_cast<double>(bytes) / seconds / 1e9 : 0)
+              << " GB/s, " << threads << " thread(s), "
+              << (fileio::crc32c_hw_available() ? "SSE4.2" : "table") << ")\n";
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,293 @@
+/*
+    Synthetic data for the write-path benchmarks, in place of HW1_4's
+    buffer of 'A's, which every compressor and cache treats as free.
+
+    A DataSpec describes an endless byte stream:
+
+        random        incompressible 32-bit hash output
+        text          arena-log-like lines, spliced from a 64 KiB
+                      dictionary in runs of 16..271 bytes (about what
+                      real logs compress to)
+        compressible  fio-style: in every 512-byte segment the first
+                      100 - percent % are random and the rest zeros, so
+                      an LZ coder gets about 100 / (100 - percent) : 1
+        fill_a        HW1_4's 'A's, for comparison
+
+    The stream is cut into 4 KiB pages and each page is a pure function
+    of (seed, page number). Any range can therefore be generated on its
+    own, by any thread, in any order, and regenerated later to check a
+    read-back: a 500 GB file never needs to exist in memory.
+
+    Random words are murmur3's fmix32 of ((word index ^ high half of
+    the page key) x golden ratio) ^ low half. Both halves matter: with
+    only 32 key bits, pages would repeat after about 2^16 of them.
+    There is no dependency between words, so the AVX2 kernel
+    hashes eight at a time (selected at run time, like crc32c.hpp) and
+    the fill runs at memory speed on each thread; fill_parallel() splits
+    big ranges across threads.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "arena_parse.hpp"
+
+namespace fileio {
+
+enum class DataKind { random, text, compressible, fill_a };
+
+struct DataSpec {
+    DataKind kind = DataKind::random;
+    unsigned compress_percent = 50; // compressible only, 0..99
+    std::uint64_t seed = 1;
+};
+
+// Accepts "random", "text", "a" or a compressible percentage "0".."99".
+inline bool parse_data_spec(std::string_view text, DataSpec& spec) {
+    if (text == "random") {
+        spec.kind = DataKind::random;
+    } else if (text == "text") {
+        spec.kind = DataKind::text;
+    } else if (text == "a") {
+        spec.kind = DataKind::fill_a;
+    } else if (arena::parse_int(text, spec.compress_percent, 0u, 99u) == arena::ParseStatus::ok) {
+        spec.kind = DataKind::compressible;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// "random", "text", "50% compressible" or "'A'", for reports.
+inline std::string describe(const DataSpec& spec) {
+    switch (spec.kind) {
+    case DataKind::random: return "random";
+    case DataKind::text: return "text";
+    case DataKind::compressible: return std::to_string(spec.compress_percent) + "% compressible";
+    case DataKind::fill_a: return "'A'";
+    }
+    return "?";
+}
+
+namespace data_gen_detail {
+
+constexpr std::size_t kPage = 4096;
+constexpr std::size_t kSegment = 512;
+constexpr std::size_t kDictionary = 64 * 1024;
+constexpr std::size_t kMaxRun = 271;
+constexpr std::uint32_t kGolden = 0x9E3779B9u;
+
+// splitmix64's finalizer.
+inline std::uint64_t mix64(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+inline std::uint32_t fmix32(std::uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    return h ^ (h >> 16);
+}
+
+inline std::uint64_t page_key(std::uint64_t seed, std::uint64_t page) {
+    return mix64(seed * 0xD1B54A32D192ED03ull + page);
+}
+
+// count words fmix32((((first + j) ^ hi) * kGolden) ^ lo), where hi and
+// lo are the halves of key, stored little-endian.
+inline void random_words_scalar(std::uint64_t key, std::uint32_t first, unsigned char* out, std::size_t count) {
+    const std::uint32_t hi = static_cast<std::uint32_t>(key >> 32);
+    const std::uint32_t lo = static_cast<std::uint32_t>(key);
+    for (std::size_t j = 0; j < count; ++j) {
+        std::uint32_t w = fmix32(((first + static_cast<std::uint32_t>(j)) ^ hi) * kGolden ^ lo);
+        std::memcpy(out + 4 * j, &w, 4);
+    }
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("avx2"))) inline void random_words_avx2(std::uint64_t key, std::uint32_t first,
+                                                               unsigned char* out, std::size_t count) {
+    const __m256i golden = _mm256_set1_epi32(static_cast<int>(kGolden));
+    const __m256i hi = _mm256_set1_epi32(static_cast<int>(key >> 32));
+    const __m256i lo = _mm256_set1_epi32(static_cast<int>(key));
+    const __m256i c1 = _mm256_set1_epi32(static_cast<int>(0x85EBCA6Bu));
+    const __m256i c2 = _mm256_set1_epi32(static_cast<int>(0xC2B2AE35u));
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i index =
+        _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(first)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    std::size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        __m256i h = _mm256_xor_si256(_mm256_mullo_epi32(_mm256_xor_si256(index, hi), golden), lo);
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+        h = _mm256_mullo_epi32(h, c1);
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+        h = _mm256_mullo_epi32(h, c2);
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4 * j), h);
+        index = _mm256_add_epi32(index, step);
+    }
+    random_words_scalar(key, first + static_cast<std::uint32_t>(j), out + 4 * j, count - j);
+}
+
+inline bool avx2_available() {
+    static const bool available = __builtin_cpu_supports("avx2");
+    return available;
+}
+
+inline void random_words(std::uint64_t key, std::uint32_t first, unsigned char* out, std::size_t count) {
+    if (avx2_available()) {
+        random_words_avx2(key, first, out, count);
+    } else {
+        random_words_scalar(key, first, out, count);
+    }
+}
+
+#else
+
+inline bool avx2_available() { return false; }
+
+inline void random_words(std::uint64_t key, std::uint32_t first, unsigned char* out, std::size_t count) {
+    random_words_scalar(key, first, out, count);
+}
+
+#endif
+
+// Round-log lines like the arena writes, seeded for reproducibility.
+inline std::vector<char> build_dictionary(std::uint64_t seed) {
+    static const char* const kTypes[] = {"int8_t", "uint8_t", "int16_t", "uint16_t", "int32_t", "uint32_t"};
+    static const char* const kOps[] = {"+", "-", "*"};
+    std::vector<char> dictionary(kDictionary);
+    std::uint64_t x = mix64(seed) | 1;
+    char line[128];
+    std::size_t pos = 0;
+    while (pos < dictionary.size()) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        int n = std::snprintf(line, sizeof(line), "round=%llu type=%s op=%s start=%d guess=%d result=%d %s\n",
+                              static_cast<unsigned long long>(x % 100000), kTypes[x % 6], kOps[(x >> 8) % 3],
+                              static_cast<int>((x >> 16) % 256) - 128, static_cast<int>((x >> 24) % 512) - 256,
+                              static_cast<int>((x >> 33) % 256) - 128, (x >> 40) % 3 == 0 ? "correct" : "wrong");
+        std::size_t take = std::min(static_cast<std::size_t>(n), dictionary.size() - pos);
+        std::memcpy(dictionary.data() + pos, line, take);
+        pos += take;
+    }
+    return dictionary;
+}
+
+} // namespace data_gen_detail
+
+class DataGenerator {
+public:
+    static constexpr std::size_t kPage = data_gen_detail::kPage;
+
+    explicit DataGenerator(const DataSpec& spec) : spec_(spec) {
+        spec_.compress_percent = std::min(spec_.compress_percent, 99u);
+        if (spec_.kind == DataKind::text) dictionary_ = data_gen_detail::build_dictionary(spec_.seed);
+    }
+
+    const DataSpec& spec() const { return spec_; }
+
+    // Whether the random kernel runs eight words at a time.
+    static bool vectorized() { return data_gen_detail::avx2_available(); }
+
+    // Writes bytes [offset, offset + n) of the stream to out.
+    void fill(std::uint64_t offset, void* out, std::size_t n) const {
+        auto* p = static_cast<unsigned char*>(out);
+        if (spec_.kind == DataKind::fill_a) {
+            std::memset(p, 'A', n);
+            return;
+        }
+        unsigned char page[kPage];
+        while (n > 0) {
+            std::uint64_t index = offset / kPage;
+            std::size_t skip = static_cast<std::size_t>(offset % kPage);
+            std::size_t take = std::min(n, kPage - skip);
+            if (take == kPage) {
+                fill_page(index, p);
+            } else {
+                fill_page(index, page);
+                std::memcpy(p, page + skip, take);
+            }
+            p += take;
+            offset += take;
+            n -= take;
+        }
+    }
+
+    // fill() split into page-aligned pieces across `threads` threads.
+    void fill_parallel(std::uint64_t offset, void* out, std::size_t n, unsigned threads) const {
+        std::size_t pages = n / kPage;
+        threads = static_cast<unsigned>(std::min<std::size_t>(std::max(threads, 1u), std::max<std::size_t>(pages, 1)));
+        if (threads == 1) {
+            fill(offset, out, n);
+            return;
+        }
+        auto* p = static_cast<unsigned char*>(out);
+        std::size_t piece = (pages + threads - 1) / threads * kPage;
+        std::vector<std::thread> pool;
+        for (std::size_t start = piece; start < n; start += piece) {
+            pool.emplace_back([this, offset, p, start, piece, n] {
+                fill(offset + start, p + start, std::min(piece, n - start));
+            });
+        }
+        fill(offset, p, std::min(piece, n));
+        for (std::thread& t : pool) t.join();
+    }
+
+private:
+    void fill_page(std::uint64_t index, unsigned char* out) const {
+        using namespace data_gen_detail;
+        std::uint64_t key = page_key(spec_.seed, index);
+        switch (spec_.kind) {
+        case DataKind::random:
+            random_words(key, 0, out, kPage / 4);
+            break;
+        case DataKind::compressible: {
+            std::size_t random_bytes = kSegment * (100 - spec_.compress_percent) / 100 / 4 * 4;
+            for (std::size_t s = 0; s < kPage; s += kSegment) {
+                random_words(key, static_cast<std::uint32_t>(s / 4), out + s, random_bytes / 4);
+                std::memset(out + s + random_bytes, 0, kSegment - random_bytes);
+            }
+            break;
+        }
+        case DataKind::text: {
+            std::uint64_t x = key | 1;
+            for (std::size_t pos = 0; pos < kPage;) {
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+                std::size_t from = static_cast<std::size_t>(x % (kDictionary - kMaxRun));
+                std::size_t take = std::min<std::size_t>(16 + (x >> 40) % (kMaxRun - 15), kPage - pos);
+                std::memcpy(out + pos, dictionary_.data() + from, take);
+                pos += take;
+            }
+            break;
+        }
+        case DataKind::fill_a:
+            std::memset(out, 'A', kPage);
+            break;
+        }
+    }
+
+    DataSpec spec_;
+    std::vector<char> dictionary_;
+};
+
+} // namespace fileio
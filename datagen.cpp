@@ -0,0 +1,175 @@
+/*
+    Writes synthetic data from data_gen.hpp to files or stdout, or with
+    no FILE just generates it and reports the rate.
+
+    SIZE takes a K, M, G or T suffix (powers of 1024) and can be far
+    larger than memory: the data is made CHUNK MiB at a time on -j
+    threads into one of two buffers while a writer thread writes the
+    other. FILE k gets seed + k, so files differ but each one can be
+    regenerated exactly (datagen -S ... SIZE - | cmp - FILE).
+
+    Build: g++ -std=c++17 -O2 -pthread datagen.cpp -o datagen
+    Usage: datagen [-d random|text|a|PERCENT] [-S seed] [-j threads]
+                   [-c chunk_MiB] SIZE [FILE|- ...]
+*/
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "arena_parse.hpp"
+#include "data_gen.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+    fileio::DataSpec spec;
+    unsigned threads = 0;
+    unsigned chunk_mib = 64;
+    std::uint64_t size = 0;
+    std::vector<std::string> files;
+};
+
+void usage() {
+    std::cerr << "usage: datagen [-d random|text|a|PERCENT] [-S seed] [-j threads]\n"
+                 "               [-c chunk_MiB] SIZE [FILE|- ...]\n";
+}
+
+bool parse_size(std::string_view text, std::uint64_t& size) {
+    unsigned shift = 0;
+    if (!text.empty()) {
+        switch (text.back()) {
+        case 'K': case 'k': shift = 10; break;
+        case 'M': case 'm': shift = 20; break;
+        case 'G': case 'g': shift = 30; break;
+        case 'T': case 't': shift = 40; break;
+        default: break;
+        }
+        if (shift != 0) text.remove_suffix(1);
+    }
+    std::uint64_t value = 0;
+    if (arena::parse_int(text, value, std::uint64_t{1}, std::numeric_limits<std::uint64_t>::max() >> shift) !=
+        arena::ParseStatus::ok) {
+        return false;
+    }
+    size = value << shift;
+    return true;
+}
+
+int write_all(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno;
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return 0;
+}
+
+// Streams config.size bytes of `generator` to fd, or nowhere if fd < 0.
+// Returns 0 or an errno value.
+int stream(const Config& config, const fileio::DataGenerator& generator, int fd, std::vector<char> (&buffers)[2]) {
+    std::size_t chunk = buffers[0].size();
+    std::thread writer;
+    int error = 0;
+    int slot = 0;
+    for (std::uint64_t offset = 0; offset < config.size; offset += chunk, slot ^= 1) {
+        std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(chunk, config.size - offset));
+        generator.fill_parallel(offset, buffers[slot].data(), n, config.threads);
+        if (writer.joinable()) writer.join();
+        if (error != 0) break;
+        if (fd >= 0) writer = std::thread([&, slot, n] { error = write_all(fd, buffers[slot].data(), n); });
+    }
+    if (writer.joinable()) writer.join();
+    return error;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config config;
+    bool have_size = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool has_value = i + 1 < argc;
+        bool ok = true;
+        if (arg == "-d" && has_value) {
+            ok = fileio::parse_data_spec(argv[++i], config.spec);
+        } else if (arg == "-S" && has_value) {
+            ok = arena::parse_int(argv[++i], config.spec.seed, std::uint64_t{0},
+                                  std::numeric_limits<std::uint64_t>::max()) == arena::ParseStatus::ok;
+        } else if (arg == "-j" && has_value) {
+            ok = arena::parse_int(argv[++i], config.threads, 1u, 1024u) == arena::ParseStatus::ok;
+        } else if (arg == "-c" && has_value) {
+            ok = arena::parse_int(argv[++i], config.chunk_mib, 1u, 4096u) == arena::ParseStatus::ok;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            ok = false;
+        } else if (!have_size) {
+            ok = have_size = parse_size(arg, config.size);
+        } else {
+            config.files.emplace_back(arg);
+        }
+        if (!ok) {
+            usage();
+            return 1;
+        }
+    }
+    if (!have_size) {
+        usage();
+        return 1;
+    }
+    if (config.threads == 0) config.threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::size_t chunk =
+        static_cast<std::size_t>(std::min<std::uint64_t>(std::uint64_t{config.chunk_mib} << 20, config.size));
+    std::vector<char> buffers[2] = {std::vector<char>(chunk), std::vector<char>(chunk)};
+
+    if (config.files.empty()) {
+        fileio::DataGenerator generator(config.spec);
+        auto t0 = Clock::now();
+        stream(config, generator, -1, buffers);
+        double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+        std::cout << std::fixed << std::setprecision(2) << static_cast<double>(config.size) / 1e9 << " GB of "
+                  << fileio::describe(config.spec) << " data in " << std::setprecision(3) << seconds << " s, "
+                  << std::setprecision(2) << static_cast<double>(config.size) / seconds / 1e9 << " GB/s on "
+                  << config.threads
+                  << " thread(s)" << (fileio::DataGenerator::vectorized() ? " (AVX2)" : "") << "\n";
+        return 0;
+    }
+
+    for (std::size_t k = 0; k < config.files.size(); ++k) {
+        const std::string& path = config.files[k];
+        fileio::DataSpec spec = config.spec;
+        spec.seed += k;
+        fileio::DataGenerator generator(spec);
+        int fd = path == "-" ? STDOUT_FILENO : ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            perror(path.c_str());
+            return 1;
+        }
+        int error = stream(config, generator, fd, buffers);
+        if (fd != STDOUT_FILENO && ::close(fd) != 0 && error == 0) error = errno;
+        if (error != 0) {
+            errno = error;
+            perror(path.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
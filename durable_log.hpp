@@ -0,0 +1,291 @@
+/*
+    An append-only file that many threads write records to, with a
+    choice of when the records become durable.
+
+    HW1_4's write() loop returns as soon as the kernel has copied the
+    bytes into the page cache; a crash before writeback loses them. The
+    fix is fdatasync(), but one per record costs a full device flush
+    each (milliseconds on a disk), which caps a writer at a few hundred
+    records per second no matter how small they are.
+
+    Group commit shares that cost. append() only copies the record into
+    a pending batch and returns its log position. One flusher thread
+    writes the batch and issues a single fdatasync() for everything in
+    it. By default it does so as soon as the previous fdatasync()
+    returns, so the groups grow by themselves with the device's sync
+    latency and the number of committers. A nonzero `interval` makes it
+    linger for more records, up to batch_bytes. Every thread whose
+    record was in the batch is then released from wait_durable(), and
+    on_durable runs once for the whole batch. With early_writeback the
+    flusher also writes out each batch_bytes / 4 as it fills and starts
+    writeback on it with sync_file_range(), so the final fdatasync()
+    has less left to do.
+
+    Durability::none writes each record straight away and never syncs;
+    Durability::per_write syncs after every record. Both exist for
+    comparison (commit_bench) and for data that does not need group
+    commit's latency trade-off.
+
+    Once a write or sync fails the log stays failed: after a failed
+    fdatasync() Linux may already have dropped the dirty pages, so
+    retrying would report data as durable that is not.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fileio {
+
+enum class Durability { none, per_write, group };
+
+class DurableLog {
+public:
+    // One commit: every record ending at or before durable_end is on
+    // stable storage (with Durability::none: handed to the kernel), or
+    // `error` says why not.
+    struct Commit {
+        std::uint64_t durable_end = 0;
+        std::uint64_t records = 0;
+        std::uint64_t bytes = 0;
+        int error = 0;
+    };
+
+    struct Options {
+        Durability mode = Durability::group;
+        std::chrono::microseconds interval{0}; // how long a group lingers for more records
+        std::size_t batch_bytes = 256 * 1024;  // stop lingering once this much is pending
+        bool early_writeback = false;
+        // Called once per commit, in log order, from whichever thread
+        // committed. It must not call back into the log.
+        std::function<void(const Commit&)> on_durable;
+    };
+
+    struct Stats {
+        std::uint64_t records = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t syncs = 0;
+    };
+
+    DurableLog() = default;
+    ~DurableLog() { close(); }
+
+    DurableLog(const DurableLog&) = delete;
+    DurableLog& operator=(const DurableLog&) = delete;
+
+    // Opens (creating if needed) `path` for appending. Returns false
+    // with errno set.
+    bool open(const char* path, const Options& options) {
+        close();
+        fd_ = ::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd_ < 0) return false;
+        struct stat st;
+        if (fstat(fd_, &st) != 0) {
+            int error = errno;
+            ::close(fd_);
+            fd_ = -1;
+            errno = error;
+            return false;
+        }
+        options_ = options;
+        end_ = durable_end_ = static_cast<std::uint64_t>(st.st_size);
+        error_ = 0;
+        stats_ = Stats{};
+        pending_.clear();
+        pending_records_ = 0;
+        group_open_ = false;
+        unsynced_ = 0;
+        stopping_ = false;
+        if (options_.mode == Durability::group) {
+            flusher_ = std::thread([this] { flush_loop(); });
+        }
+        return true;
+    }
+
+    // Appends one record and returns the log position just past it, to
+    // pass to wait_durable(). In group mode it only queues the record.
+    std::uint64_t append(const void* data, std::size_t size) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (options_.mode != Durability::group) {
+            return append_direct(lock, data, size);
+        }
+        const char* bytes = static_cast<const char*>(data);
+        pending_.insert(pending_.end(), bytes, bytes + size);
+        ++pending_records_;
+        end_ += size;
+        std::uint64_t lsn = end_;
+        bool wake = false;
+        if (!group_open_) {
+            // First record of a group: the flusher starts its clock.
+            group_open_ = true;
+            group_deadline_ = Clock::now() + options_.interval;
+            wake = true;
+        }
+        wake = wake || pending_.size() >= writeback_bytes() || unsynced_ + pending_.size() >= options_.batch_bytes;
+        lock.unlock();
+        if (wake) work_cv_.notify_one();
+        return lsn;
+    }
+
+    // Waits until every record up to `lsn` is durable. Returns 0 or the
+    // errno of the write or sync that failed.
+    int wait_durable(std::uint64_t lsn) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        durable_cv_.wait(lock, [&] { return durable_end_ >= lsn || error_ != 0; });
+        return durable_end_ >= lsn ? 0 : error_;
+    }
+
+    // append() and wait_durable() in one call.
+    int commit(const void* data, std::size_t size) { return wait_durable(append(data, size)); }
+
+    // Commits whatever is pending and closes the file.
+    void close() {
+        if (fd_ < 0) return;
+        if (flusher_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            work_cv_.notify_one();
+            flusher_.join();
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Pending bytes that make the flusher write early (without a sync).
+    std::size_t writeback_bytes() const {
+        return options_.early_writeback ? std::max<std::size_t>(options_.batch_bytes / 4, 1) : options_.batch_bytes;
+    }
+
+    static int write_all(int fd, const char* data, std::size_t size) {
+        while (size > 0) {
+            ssize_t n = ::write(fd, data, size);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return errno;
+            }
+            data += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return 0;
+    }
+
+    // none and per_write: the caller's thread does the I/O, holding the
+    // lock so records stay in order.
+    std::uint64_t append_direct(std::unique_lock<std::mutex>& lock, const void* data, std::size_t size) {
+        Commit commit;
+        if (error_ == 0) {
+            error_ = write_all(fd_, static_cast<const char*>(data), size);
+            if (error_ == 0 && options_.mode == Durability::per_write) {
+                if (::fdatasync(fd_) != 0) error_ = errno;
+                ++stats_.syncs;
+            }
+        }
+        end_ += size;
+        ++stats_.records;
+        stats_.bytes += size;
+        if (error_ == 0) durable_end_ = end_;
+        commit = {durable_end_, 1, size, error_};
+        // Still under the lock, so that commits are reported in order.
+        if (options_.on_durable) options_.on_durable(commit);
+        std::uint64_t lsn = end_;
+        lock.unlock();
+        durable_cv_.notify_all();
+        return lsn;
+    }
+
+    void flush_loop() {
+        std::vector<char> batch;
+        std::uint64_t group_records = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            work_cv_.wait(lock, [&] { return stopping_ || group_open_; });
+            if (!group_open_) return;
+            work_cv_.wait_until(lock, group_deadline_, [&] {
+                return stopping_ || pending_.size() >= writeback_bytes() ||
+                       unsynced_ + pending_.size() >= options_.batch_bytes;
+            });
+            bool commit_now = stopping_ || Clock::now() >= group_deadline_ ||
+                              unsynced_ + pending_.size() >= options_.batch_bytes;
+            batch.swap(pending_);
+            std::uint64_t records = pending_records_;
+            pending_records_ = 0;
+            std::uint64_t batch_end = end_;
+            // Records appended from here on start the next group.
+            if (commit_now) group_open_ = false;
+            int error = error_; // a failed log writes nothing more
+            lock.unlock();
+
+            if (error == 0) error = write_all(fd_, batch.data(), batch.size());
+            if (error == 0 && !commit_now) {
+                // Start writeback now; the group's fdatasync waits for it.
+                ::sync_file_range(fd_, static_cast<off64_t>(batch_end - batch.size()),
+                                  static_cast<off64_t>(batch.size()), SYNC_FILE_RANGE_WRITE);
+            } else if (error == 0 && ::fdatasync(fd_) != 0) {
+                error = errno;
+            }
+
+            lock.lock();
+            stats_.records += records;
+            stats_.bytes += batch.size();
+            unsynced_ += batch.size();
+            group_records += records;
+            batch.clear();
+            if (!commit_now && error == 0) continue;
+            // A failed early write ends the group; later records fail too.
+            if (!commit_now) group_open_ = !pending_.empty();
+
+            if (commit_now) ++stats_.syncs;
+            if (error_ == 0) error_ = error;
+            if (error_ == 0) durable_end_ = batch_end;
+            Commit commit{durable_end_, group_records, unsynced_, error_};
+            group_records = 0;
+            unsynced_ = 0;
+            lock.unlock();
+            durable_cv_.notify_all();
+            if (options_.on_durable) options_.on_durable(commit);
+            lock.lock();
+        }
+    }
+
+    int fd_ = -1;
+    Options options_;
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable durable_cv_;
+    std::thread flusher_;
+    bool stopping_ = false;
+
+    std::vector<char> pending_;
+    std::uint64_t pending_records_ = 0;
+    bool group_open_ = false; // records are pending or written but not synced
+    Clock::time_point group_deadline_;
+    std::uint64_t unsynced_ = 0; // bytes written early in the open group
+    std::uint64_t end_ = 0;      // log position after the last append()
+    std::uint64_t durable_end_ = 0;
+    int error_ = 0;
+    Stats stats_;
+};
+
+} // namespace fileio
@@ -0,0 +1,486 @@
+/*
+    Exhaustive float32 precision sweep behind the 0.1f + 0.2f lesson.
+
+    Runs `x op y` for every one of the 2^32 float bit patterns x and a
+    fixed y (default: x + 0.2f), in each of the four IEEE rounding
+    modes, and reports:
+      - how far the float result is from the same operation done in
+        double and in long double, in float ULPs at the reference
+        value (exact, <= 0.5, <= 1, <= 2, > 2, and the max)
+      - how many results differ from the round-to-nearest result
+      - NaN / inf / subnormal / zero counts for inputs and results,
+        and how many finite inputs overflowed to inf
+
+    The references are computed once per input, rounded to nearest;
+    only the float operation is redone in each mode (set with
+    fesetround() per chunk). The build needs -frounding-math, and the
+    mode loop also pins its operands and results with empty asm so the
+    arithmetic cannot move across a mode switch. Float and double work
+    runs four and two lanes at a time with SSE2, including the error
+    bucketing; only the long double reference goes through the x87
+    unit one value at a time. The 2^32 inputs are split into chunks
+    across a thread pool.
+
+    Build: g++ -std=c++17 -O2 -frounding-math -pthread float_sweep.cpp -o float_sweep
+    Usage: float_sweep [-j threads] [--op add|sub|mul|div] [--y VALUE]
+*/
+#include <algorithm>
+#include <atomic>
+#include <cfenv>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <emmintrin.h>
+
+#include "arena_parse.hpp"
+
+static_assert(std::numeric_limits<long double>::digits == 64, "expects x87 80-bit long double");
+
+namespace {
+
+constexpr std::uint64_t kPatterns = 1ULL << 32;
+constexpr std::uint32_t kChunk = 1 << 16;
+
+enum class Op { add, sub, mul, div };
+
+constexpr int kModes = 4;
+constexpr int kModeFlags[kModes] = {FE_TONEAREST, FE_DOWNWARD, FE_UPWARD, FE_TOWARDZERO};
+constexpr const char* kModeNames[kModes] = {"to nearest", "downward", "upward", "toward zero"};
+
+// ULP error buckets, in float ULPs at the reference value.
+constexpr int kBuckets = 5;
+constexpr const char* kBucketNames[kBuckets] = {"exact", "<=0.5", "<=1", "<=2", ">2"};
+constexpr double kThresholds[kBuckets - 1] = {0.0, 0.5, 1.0, 2.0};
+
+enum class Kind { nan, inf, subnormal, zero, normal, count };
+constexpr int kKinds = static_cast<int>(Kind::count);
+constexpr const char* kKindNames[kKinds] = {"NaN", "inf", "subnormal", "zero", "normal"};
+
+Kind kind_of(std::uint32_t bits) {
+    std::uint32_t exponent = (bits >> 23) & 0xFF;
+    std::uint32_t mantissa = bits & 0x7FFFFF;
+    if (exponent == 0xFF) return mantissa ? Kind::nan : Kind::inf;
+    if (exponent == 0) return mantissa ? Kind::subnormal : Kind::zero;
+    return Kind::normal;
+}
+
+struct ErrorTally {
+    std::uint64_t within[kBuckets - 1] = {}; // results at most kThresholds[t] ULPs off
+    std::uint64_t compared = 0;
+    double max_ulps = 0;
+    std::uint64_t not_comparable = 0; // NaN on one side only, or inf vs finite
+
+    void record(double ulps) {
+        ++compared;
+        for (int t = 0; t < kBuckets - 1; ++t) {
+            if (ulps <= kThresholds[t]) ++within[t];
+        }
+        if (ulps > max_ulps) max_ulps = ulps;
+    }
+
+    std::uint64_t bucket(int b) const {
+        if (b == 0) return within[0];
+        if (b == kBuckets - 1) return compared - within[kBuckets - 2];
+        return within[b] - within[b - 1];
+    }
+
+    void add(const ErrorTally& o) {
+        for (int t = 0; t < kBuckets - 1; ++t) within[t] += o.within[t];
+        compared += o.compared;
+        max_ulps = std::max(max_ulps, o.max_ulps);
+        not_comparable += o.not_comparable;
+    }
+};
+
+struct ModeTally {
+    ErrorTally vs_double;
+    ErrorTally vs_long_double;
+    std::uint64_t results[kKinds] = {};
+    std::uint64_t overflows = 0; // finite x, inf result
+    std::uint64_t differ_from_nearest = 0;
+
+    void add(const ModeTally& o) {
+        vs_double.add(o.vs_double);
+        vs_long_double.add(o.vs_long_double);
+        for (int k = 0; k < kKinds; ++k) results[k] += o.results[k];
+        overflows += o.overflows;
+        differ_from_nearest += o.differ_from_nearest;
+    }
+};
+
+struct Tally {
+    std::uint64_t inputs[kKinds] = {};
+    ModeTally modes[kModes];
+
+    void add(const Tally& o) {
+        for (int k = 0; k < kKinds; ++k) inputs[k] += o.inputs[k];
+        for (int m = 0; m < kModes; ++m) modes[m].add(o.modes[m]);
+    }
+};
+
+// Non-finite cases, done one value at a time. A float op never
+// overflows double or long double, so a non-finite reference is the
+// same in both.
+void compare_scalar(float result, double reference, ErrorTally& tally) {
+    if (std::isnan(result) || std::isnan(reference)) {
+        if (std::isnan(result) && std::isnan(reference)) {
+            tally.record(0.0);
+        } else {
+            ++tally.not_comparable;
+        }
+    } else if (std::isinf(reference) && result == reference) {
+        tally.record(0.0);
+    } else {
+        ++tally.not_comparable;
+    }
+}
+
+// An empty asm that claims to change v: arithmetic producing or using
+// v stays on its side of the surrounding fesetround() calls.
+template <typename V>
+inline void pin(V& v) {
+    asm volatile("" : "+x"(v));
+}
+
+template <Op op>
+__m128 op_ps(__m128 a, __m128 b) {
+    if constexpr (op == Op::add) return _mm_add_ps(a, b);
+    if constexpr (op == Op::sub) return _mm_sub_ps(a, b);
+    if constexpr (op == Op::mul) return _mm_mul_ps(a, b);
+    return _mm_div_ps(a, b);
+}
+
+template <Op op>
+__m128d op_pd(__m128d a, __m128d b) {
+    if constexpr (op == Op::add) return _mm_add_pd(a, b);
+    if constexpr (op == Op::sub) return _mm_sub_pd(a, b);
+    if constexpr (op == Op::mul) return _mm_mul_pd(a, b);
+    return _mm_div_pd(a, b);
+}
+
+template <Op op>
+long double op_ld(long double a, long double b) {
+    if constexpr (op == Op::add) return a + b;
+    if constexpr (op == Op::sub) return a - b;
+    if constexpr (op == Op::mul) return a * b;
+    return a / b;
+}
+
+struct Scratch {
+    alignas(16) std::uint32_t nearest[kChunk];
+    alignas(16) std::uint32_t result[kChunk];
+    alignas(16) double reference[kChunk];  // x op y in double
+    alignas(16) double correction[kChunk]; // long double result minus `reference`
+};
+
+// Counting inside the per-chunk loops stays in vector registers: a
+// compare mask is all ones (-1) in each hit lane, so subtracting the
+// mask from a counter adds one per hit lane.
+__m128i count_hits(__m128i counter, __m128 mask) { return _mm_sub_epi32(counter, _mm_castps_si128(mask)); }
+__m128i count_hits(__m128i counter, __m128d mask) { return _mm_sub_epi64(counter, _mm_castpd_si128(mask)); }
+
+std::uint64_t lane_sum32(__m128i v) {
+    alignas(16) std::uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), v);
+    return std::uint64_t{lanes[0]} + lanes[1] + lanes[2] + lanes[3];
+}
+
+std::uint64_t lane_sum64(__m128i v) {
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), v);
+    return lanes[0] + lanes[1];
+}
+
+// ErrorTally for two double lanes at a time.
+class LaneErrors {
+public:
+    // `live` masks the lanes to count.
+    void record(__m128d ulps, __m128d live) {
+        compared_ = count_hits(compared_, live);
+#pragma GCC unroll 4
+        for (int t = 0; t < kBuckets - 1; ++t) {
+            within_[t] = count_hits(within_[t], _mm_and_pd(live, _mm_cmple_pd(ulps, _mm_set1_pd(kThresholds[t]))));
+        }
+        max_ = _mm_max_pd(max_, _mm_and_pd(live, ulps));
+    }
+
+    void add_to(ErrorTally& tally) const {
+        tally.compared += lane_sum64(compared_);
+        for (int t = 0; t < kBuckets - 1; ++t) tally.within[t] += lane_sum64(within_[t]);
+        alignas(16) double lanes[2];
+        _mm_store_pd(lanes, max_);
+        tally.max_ulps = std::max(tally.max_ulps, std::max(lanes[0], lanes[1]));
+    }
+
+private:
+    __m128i within_[kBuckets - 1] = {};
+    __m128i compared_ = _mm_setzero_si128();
+    __m128d max_ = _mm_setzero_pd();
+};
+
+// Float results for one rounding mode against the references: ULP
+// errors, result kinds, overflows and differences from round-to-nearest.
+void tally_chunk(std::uint32_t first, const Scratch& s, ModeTally& mt) {
+    const __m128i exponent_mask = _mm_set1_epi32(0x7F800000);
+    const __m128i mantissa_mask = _mm_set1_epi32(0x007FFFFF);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128d sign_mask = _mm_set1_pd(-0.0);
+    const __m128d exponent_mask_pd = _mm_castsi128_pd(_mm_set1_epi64x(0x7FF0000000000000LL));
+    const __m128d inf_pd = _mm_set1_pd(std::numeric_limits<double>::infinity());
+
+    __m128i nans = zero, infs = zero, subnormals = zero, zeros = zero;
+    __m128i overflows = zero, same_as_nearest = zero;
+    LaneErrors vs_double;
+    LaneErrors vs_long_double;
+
+    __m128i x_bits = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(first)), _mm_set_epi32(3, 2, 1, 0));
+    for (std::uint32_t i = 0; i < kChunk; i += 4) {
+        __m128i r_bits = _mm_load_si128(reinterpret_cast<const __m128i*>(s.result + i));
+        __m128i n_bits = _mm_load_si128(reinterpret_cast<const __m128i*>(s.nearest + i));
+
+        __m128i exponent = _mm_and_si128(r_bits, exponent_mask);
+        __m128 max_exponent = _mm_castsi128_ps(_mm_cmpeq_epi32(exponent, exponent_mask));
+        __m128 min_exponent = _mm_castsi128_ps(_mm_cmpeq_epi32(exponent, zero));
+        __m128 no_mantissa = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(r_bits, mantissa_mask), zero));
+        __m128 nan = _mm_andnot_ps(no_mantissa, max_exponent);
+        __m128 inf = _mm_and_ps(no_mantissa, max_exponent);
+        nans = count_hits(nans, nan);
+        infs = count_hits(infs, inf);
+        subnormals = count_hits(subnormals, _mm_andnot_ps(no_mantissa, min_exponent));
+        zeros = count_hits(zeros, _mm_and_ps(no_mantissa, min_exponent));
+
+        __m128 x_special = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(x_bits, exponent_mask), exponent_mask));
+        overflows = count_hits(overflows, _mm_andnot_ps(x_special, inf));
+
+        __m128 n_nan = _mm_andnot_ps(
+            _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(n_bits, mantissa_mask), zero)),
+            _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(n_bits, exponent_mask), exponent_mask)));
+        same_as_nearest = count_hits(same_as_nearest,
+                                     _mm_or_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(r_bits, n_bits)), _mm_and_ps(nan, n_nan)));
+
+        __m128 r4 = _mm_castsi128_ps(r_bits);
+#pragma GCC unroll 2
+        for (int half = 0; half < 2; ++half) {
+            __m128d r = _mm_cvtps_pd(half == 0 ? r4 : _mm_movehl_ps(r4, r4));
+            const double* reference = s.reference + i + 2 * half;
+            __m128d ref = _mm_load_pd(reference);
+            __m128d finite = _mm_and_pd(_mm_cmplt_pd(_mm_andnot_pd(sign_mask, ref), inf_pd),
+                                        _mm_cmplt_pd(_mm_andnot_pd(sign_mask, r), inf_pd));
+
+            // One float ULP at ref is 2^exponent(ref) * 2^-23, with
+            // subnormals sharing the ULP of the smallest normal binade.
+            __m128d binade = _mm_max_pd(_mm_and_pd(ref, exponent_mask_pd), _mm_set1_pd(0x1p-126));
+            __m128d ulp = _mm_mul_pd(binade, _mm_set1_pd(0x1p-23));
+            __m128d diff = _mm_sub_pd(r, ref);
+            __m128d correction = _mm_load_pd(s.correction + i + 2 * half);
+            vs_double.record(_mm_div_pd(_mm_andnot_pd(sign_mask, diff), ulp), finite);
+            vs_long_double.record(_mm_div_pd(_mm_andnot_pd(sign_mask, _mm_sub_pd(diff, correction)), ulp), finite);
+
+            int finite_lanes = _mm_movemask_pd(finite);
+            if (finite_lanes != 3) {
+                const float* r_lanes = reinterpret_cast<const float*>(s.result + i + 2 * half);
+                for (int lane = 0; lane < 2; ++lane) {
+                    if (finite_lanes & (1 << lane)) continue;
+                    compare_scalar(r_lanes[lane], reference[lane], mt.vs_double);
+                    compare_scalar(r_lanes[lane], reference[lane], mt.vs_long_double);
+                }
+            }
+        }
+        x_bits = _mm_add_epi32(x_bits, _mm_set1_epi32(4));
+    }
+
+    std::uint64_t counts[kKinds - 1] = {lane_sum32(nans), lane_sum32(infs), lane_sum32(subnormals), lane_sum32(zeros)};
+    std::uint64_t special = 0;
+    for (int k = 0; k < kKinds - 1; ++k) {
+        mt.results[k] += counts[k];
+        special += counts[k];
+    }
+    mt.results[static_cast<int>(Kind::normal)] += kChunk - special;
+    mt.overflows += lane_sum32(overflows);
+    mt.differ_from_nearest += kChunk - lane_sum32(same_as_nearest);
+    vs_double.add_to(mt.vs_double);
+    vs_long_double.add_to(mt.vs_long_double);
+}
+
+template <Op op>
+void sweep_chunk(std::uint32_t first, float y, Scratch& s, Tally& tally) {
+    const __m128 ys = _mm_set1_ps(y);
+    const __m128d yd = _mm_set1_pd(static_cast<double>(y));
+    const long double yl = y;
+    const __m128i base = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(first)), _mm_set_epi32(3, 2, 1, 0));
+    const __m128i step = _mm_set1_epi32(4);
+
+    // References, once per chunk and always rounded to nearest.
+    std::fesetround(FE_TONEAREST);
+    __m128i lanes = base;
+    for (std::uint32_t i = 0; i < kChunk; i += 4) {
+        __m128 xs = _mm_castsi128_ps(lanes);
+        _mm_store_pd(s.reference + i, op_pd<op>(_mm_cvtps_pd(xs), yd));
+        _mm_store_pd(s.reference + i + 2, op_pd<op>(_mm_cvtps_pd(_mm_movehl_ps(xs, xs)), yd));
+        lanes = _mm_add_epi32(lanes, step);
+    }
+    for (std::uint32_t i = 0; i < kChunk; ++i) {
+        std::uint32_t x_bits = first + i;
+        float x;
+        std::memcpy(&x, &x_bits, sizeof(x));
+        ++tally.inputs[static_cast<int>(kind_of(x_bits))];
+        long double exact = op_ld<op>(static_cast<long double>(x), yl);
+        double c = static_cast<double>(exact - static_cast<long double>(s.reference[i]));
+        s.correction[i] = std::isfinite(c) ? c : 0.0;
+    }
+
+    for (int m = 0; m < kModes; ++m) {
+        std::fesetround(kModeFlags[m]);
+        lanes = base;
+        for (std::uint32_t i = 0; i < kChunk; i += 4) {
+            __m128 xs = _mm_castsi128_ps(lanes);
+            __m128 y_in = ys;
+            pin(xs);
+            pin(y_in);
+            __m128 r = op_ps<op>(xs, y_in);
+            pin(r);
+            _mm_store_si128(reinterpret_cast<__m128i*>(s.result + i), _mm_castps_si128(r));
+            lanes = _mm_add_epi32(lanes, step);
+        }
+        std::fesetround(FE_TONEAREST);
+        if (m == 0) {
+            std::memcpy(s.nearest, s.result, sizeof(s.nearest));
+        }
+
+        tally_chunk(first, s, tally.modes[m]);
+    }
+}
+
+template <Op op>
+Tally sweep(float y, unsigned threads) {
+    constexpr std::uint64_t kChunks = kPatterns / kChunk;
+    std::vector<Tally> partial(threads);
+    std::atomic<std::uint64_t> next{0};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            std::vector<Scratch> scratch(1);
+            for (std::uint64_t c = next++; c < kChunks; c = next++) {
+                sweep_chunk<op>(static_cast<std::uint32_t>(c * kChunk), y, scratch[0], partial[t]);
+            }
+        });
+    }
+    for (std::thread& th : pool) {
+        th.join();
+    }
+    Tally total;
+    for (const Tally& p : partial) {
+        total.add(p);
+    }
+    return total;
+}
+
+void print_errors(const char* label, const ErrorTally& e) {
+    std::cout << "  " << std::left << std::setw(16) << label << std::right;
+    for (int b = 0; b < kBuckets; ++b) {
+        std::cout << std::setw(12) << e.bucket(b);
+    }
+    std::cout << std::setw(10) << std::setprecision(3) << e.max_ulps << std::setw(10) << e.not_comparable << "\n";
+}
+
+void usage() {
+    std::cerr << "usage: float_sweep [-j threads] [--op add|sub|mul|div] [--y VALUE]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    Op op = Op::add;
+    float y = 0.2f;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            if (arena::parse_int(argv[++i], threads, 1u, 1024u) != arena::ParseStatus::ok) {
+                usage();
+                return 1;
+            }
+        } else if (arg == "--op" && i + 1 < argc) {
+            std::string_view name = argv[++i];
+            if (name == "add") {
+                op = Op::add;
+            } else if (name == "sub") {
+                op = Op::sub;
+            } else if (name == "mul") {
+                op = Op::mul;
+            } else if (name == "div") {
+                op = Op::div;
+            } else {
+                usage();
+                return 1;
+            }
+        } else if (arg == "--y" && i + 1 < argc) {
+            std::string_view text = arena::trim(argv[++i]);
+            auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), y);
+            if (ec != std::errc() || ptr != text.data() + text.size()) {
+                usage();
+                return 1;
+            }
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    static constexpr const char* kOpSymbols[] = {"+", "-", "*", "/"};
+    std::uint32_t y_bits;
+    std::memcpy(&y_bits, &y, sizeof(y_bits));
+    std::cout << "Sweep: x " << kOpSymbols[static_cast<int>(op)] << " y for all 2^32 float x, y = "
+              << std::setprecision(9) << y << " (0x" << std::hex << std::setw(8) << std::setfill('0')
+              << y_bits << std::dec << std::setfill(' ') << "), " << threads << " thread(s)\n";
+
+    auto t0 = std::chrono::steady_clock::now();
+    Tally tally;
+    switch (op) {
+        case Op::add: tally = sweep<Op::add>(y, threads); break;
+        case Op::sub: tally = sweep<Op::sub>(y, threads); break;
+        case Op::mul: tally = sweep<Op::mul>(y, threads); break;
+        case Op::div: tally = sweep<Op::div>(y, threads); break;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << "\nInputs:";
+    for (int k = 0; k < kKinds; ++k) {
+        std::cout << "  " << kKindNames[k] << " " << tally.inputs[k];
+    }
+    std::cout << "\n";
+
+    for (int m = 0; m < kModes; ++m) {
+        const ModeTally& mt = tally.modes[m];
+        std::cout << "\nRounding " << kModeNames[m] << "\n";
+        std::cout << "  " << std::left << std::setw(16) << "ULP error vs" << std::right;
+        for (int b = 0; b < kBuckets; ++b) {
+            std::cout << std::setw(12) << kBucketNames[b];
+        }
+        std::cout << std::setw(10) << "max" << std::setw(10) << "n/a" << "\n";
+        print_errors("double", mt.vs_double);
+        print_errors("long double", mt.vs_long_double);
+        std::cout << "  results:";
+        for (int k = 0; k < kKinds; ++k) {
+            std::cout << "  " << kKindNames[k] << " " << mt.results[k];
+        }
+        std::cout << "\n  finite inputs that overflowed to inf: " << mt.overflows << "\n";
+        if (m != 0) {
+            std::cout << "  results that differ from round-to-nearest: " << mt.differ_from_nearest << "\n";
+        }
+    }
+
+    double evaluations = static_cast<double>(kPatterns) * kModes;
+    std::cout << "\n" << std::fixed << std::setprecision(2) << seconds << " s, "
+              << std::setprecision(0) << evaluations / seconds / 1e6 << " M evaluations/s\n";
+    return 0;
+}
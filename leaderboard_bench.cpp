@@ -0,0 +1,153 @@
+/*
+    Many processes updating one arena leaderboard at once.
+
+    Forks -p player processes. Each claims a slot on a private board and
+    records -r rounds as fast as it can, alternating right and wrong, so
+    that every published state has correct == (rounds + 1) / 2. While
+    they run, the parent takes snapshots and checks that invariant and
+    each slot's name on every row. A torn read (a row mixing two
+    updates) would break it. Prints updates/s summed over all players,
+    snapshots/s, rows skipped because their writer was mid-update (a
+    tight update loop is almost never outside one; a real round is
+    mostly waiting for the player), and the number of bad rows, which
+    must be 0.
+
+    Build: g++ -std=c++17 -O2 leaderboard_bench.cpp -o leaderboard_bench
+    Usage: leaderboard_bench [-p players] [-r rounds]
+*/
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "arena_leaderboard.hpp"
+#include "arena_parse.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void usage() {
+    std::cerr << "usage: leaderboard_bench [-p players] [-r rounds]\n";
+}
+
+std::string player_name(std::uint32_t pid) {
+    return "bench-" + std::to_string(pid);
+}
+
+// Child: waits for the start byte, then plays.
+[[noreturn]] void play(const char* board_name, int start_fd, unsigned rounds) {
+    arena::Leaderboard board;
+    if (board.open(board_name) != arena::BoardStatus::ok) _exit(2);
+    arena::LeaderboardSlot slot = board.claim(player_name(static_cast<std::uint32_t>(getpid())));
+    if (!slot) _exit(3);
+    char go;
+    if (read(start_fd, &go, 1) != 1) _exit(4);
+    for (unsigned i = 0; i < rounds; ++i) slot.record_round(i % 2 == 0);
+    _exit(0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned players = 1000;
+    unsigned rounds = 20000;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool ok = false;
+        if (arg == "-p" && i + 1 < argc) {
+            ok = arena::parse_int(argv[++i], players, 1u, arena::leaderboard_format::kCapacity) ==
+                 arena::ParseStatus::ok;
+        } else if (arg == "-r" && i + 1 < argc) {
+            ok = arena::parse_int(argv[++i], rounds, 1u, 1u << 30) == arena::ParseStatus::ok;
+        }
+        if (!ok) {
+            usage();
+            return 1;
+        }
+    }
+
+    std::string board_name = "/leaderboard_bench." + std::to_string(getpid());
+    arena::Leaderboard board;
+    if (board.open(board_name.c_str()) != arena::BoardStatus::ok) {
+        perror(board_name.c_str());
+        return 1;
+    }
+    int start[2];
+    if (pipe(start) != 0) {
+        perror("pipe");
+        return 1;
+    }
+
+    std::vector<pid_t> children;
+    for (unsigned i = 0; i < players; ++i) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            break;
+        }
+        if (pid == 0) {
+            close(start[1]);
+            play(board_name.c_str(), start[0], rounds);
+        }
+        children.push_back(pid);
+    }
+    close(start[0]);
+    while (board.claimed() < children.size()) usleep(1000);
+
+    // One byte per child starts them together; EOF would read as an
+    // error.
+    std::vector<char> go(children.size(), 'g');
+    auto t0 = Clock::now();
+    if (write(start[1], go.data(), go.size()) != static_cast<ssize_t>(go.size())) {
+        perror("write");
+    }
+    close(start[1]);
+
+    std::uint64_t snapshots = 0;
+    std::uint64_t rows_checked = 0;
+    std::uint64_t bad_rows = 0;
+    std::uint64_t skipped = 0;
+    std::size_t finished = 0;
+    int failed = 0;
+    while (finished < children.size()) {
+        std::size_t stuck = 0;
+        for (const arena::LeaderboardRow& row : board.snapshot(&stuck)) {
+            ++rows_checked;
+            if (row.score != (row.rounds + 1) / 2 || row.name != player_name(row.pid)) ++bad_rows;
+        }
+        ++snapshots;
+        skipped += stuck;
+        int status;
+        while (finished < children.size()) {
+            pid_t pid = waitpid(-1, &status, WNOHANG);
+            if (pid <= 0) break;
+            ++finished;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ++failed;
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    std::uint64_t total_rounds = 0;
+    for (const arena::LeaderboardRow& row : board.snapshot()) {
+        total_rounds += row.rounds;
+        if (row.rounds != rounds || row.score != (rounds + 1) / 2) ++bad_rows;
+    }
+    board.close();
+    arena::Leaderboard::remove(board_name.c_str());
+
+    std::cout << children.size() << " player processes x " << rounds << " rounds, " << total_rounds
+              << " updates in " << std::fixed << std::setprecision(3) << seconds << " s\n";
+    std::cout << "updates:   " << std::setprecision(0) << static_cast<double>(total_rounds) / seconds << "/s\n";
+    std::cout << "snapshots: " << snapshots << " (" << rows_checked << " rows, " << skipped << " mid-update), "
+              << static_cast<double>(snapshots) / seconds << "/s while updating\n";
+    std::cout << "bad rows:  " << bad_rows << ", failed players: " << failed << "\n";
+    return bad_rows == 0 && failed == 0 && total_rounds == std::uint64_t{rounds} * children.size() ? 0 : 1;
+}
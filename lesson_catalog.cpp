@@ -0,0 +1,236 @@
+/*
+    Compiles a lesson text source into a binary catalog (see
+    lesson_catalog.hpp), or into the C++ header that builds English
+    into the programs.
+
+    Source format, one line at a time:
+      ; comment          ignored
+      @name              starts the text for ID `name`
+      # Title            a heading, rendered exactly as print_heading()
+      anything else      text, kept as is plus a newline; a trailing
+                         backslash drops the newline instead
+    Blank lines at the end of a text are dropped, so texts can be
+    separated by one. Every ID must be defined exactly once.
+
+    Build: g++ -std=c++17 -O2 lesson_catalog.cpp -o lesson_catalog
+    Usage: lesson_catalog SOURCE -o CATALOG
+           lesson_catalog SOURCE --header HEADER
+           After changing lessons/en.txt or the ID list, regenerate
+           lesson_text_en.hpp with --header.
+*/
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arena_output.hpp"
+#include "arena_parse.hpp"
+#include "lesson_catalog.hpp"
+
+namespace {
+
+void usage() {
+    std::cerr << "usage: lesson_catalog SOURCE (-o CATALOG | --header HEADER)\n";
+}
+
+struct Catalog {
+    std::vector<std::uint32_t> offsets;
+    std::string strings;
+};
+
+int find_id(std::string_view name) {
+    for (std::uint32_t i = 0; i < arena::kTextCount; ++i) {
+        if (name == arena::kTextNames[i]) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+// Returns false after printing the first error.
+bool compile(const char* path, std::string_view source, Catalog& catalog) {
+    std::vector<std::string> texts(arena::kTextCount);
+    std::vector<bool> defined(arena::kTextCount, false);
+    std::string* text = nullptr;
+    std::size_t blank_lines = 0; // held back until more text follows
+
+    std::string rendered;
+    arena::StringAppendBuffer sink(rendered);
+    std::ostream heading_out(&sink);
+
+    std::size_t line_number = 0;
+    while (!source.empty()) {
+        std::size_t end = source.find('\n');
+        std::string_view line = source.substr(0, end);
+        source.remove_prefix(end == std::string_view::npos ? source.size() : end + 1);
+        ++line_number;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+        if (!line.empty() && line[0] == ';') continue;
+        if (!line.empty() && line[0] == '@') {
+            int id = find_id(line.substr(1));
+            if (id < 0) {
+                std::fprintf(stderr, "%s:%zu: unknown text id '%.*s'\n", path, line_number,
+                             static_cast<int>(line.size() - 1), line.data() + 1);
+                return false;
+            }
+            if (defined[static_cast<std::size_t>(id)]) {
+                std::fprintf(stderr, "%s:%zu: '%s' is defined twice\n", path, line_number, arena::kTextNames[id]);
+                return false;
+            }
+            defined[static_cast<std::size_t>(id)] = true;
+            text = &texts[static_cast<std::size_t>(id)];
+            blank_lines = 0;
+            continue;
+        }
+        if (text == nullptr) {
+            if (line.empty()) continue;
+            std::fprintf(stderr, "%s:%zu: text before the first @id\n", path, line_number);
+            return false;
+        }
+        if (line.empty()) {
+            ++blank_lines;
+            continue;
+        }
+
+        text->append(blank_lines, '\n');
+        blank_lines = 0;
+        if (line.size() >= 2 && line[0] == '#' && line[1] == ' ') {
+            rendered.clear();
+            arena::print_heading(heading_out, line.substr(2));
+            *text += rendered;
+        } else if (line.back() == '\\') {
+            line.remove_suffix(1);
+            *text += line;
+        } else {
+            *text += line;
+            *text += '\n';
+        }
+    }
+
+    bool complete = true;
+    for (std::uint32_t i = 0; i < arena::kTextCount; ++i) {
+        if (!defined[i]) {
+            std::fprintf(stderr, "%s: missing text '%s'\n", path, arena::kTextNames[i]);
+            complete = false;
+        }
+    }
+    if (!complete) return false;
+
+    catalog.offsets.assign(1, 0);
+    for (const std::string& t : texts) {
+        catalog.strings += t;
+        catalog.offsets.push_back(static_cast<std::uint32_t>(catalog.strings.size()));
+    }
+    return true;
+}
+
+bool write_catalog(const char* path, const Catalog& catalog) {
+    arena::catalog_format::FileHeader header{};
+    std::memcpy(header.magic, arena::catalog_format::kMagic, sizeof(header.magic));
+    header.version = arena::catalog_format::kVersion;
+    header.count = arena::kTextCount;
+    header.names_hash = arena::catalog_format::names_hash();
+    header.strings_size = static_cast<std::uint32_t>(catalog.strings.size());
+
+    std::FILE* f = std::fopen(path, "wb");
+    if (f == nullptr) return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+              std::fwrite(catalog.offsets.data(), sizeof(std::uint32_t), catalog.offsets.size(), f) ==
+                  catalog.offsets.size() &&
+              std::fwrite(catalog.strings.data(), 1, catalog.strings.size(), f) == catalog.strings.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+// One C string literal per source line; bytes outside printable ASCII
+// become octal escapes, which never run into a following character.
+void write_literal_lines(std::FILE* f, std::string_view text) {
+    while (!text.empty()) {
+        std::size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end == std::string_view::npos ? text.size() : end + 1);
+        text.remove_prefix(line.size());
+        std::fputs("    \"", f);
+        for (char c : line) {
+            auto u = static_cast<unsigned char>(c);
+            if (c == '\n') {
+                std::fputs("\\n", f);
+            } else if (c == '"' || c == '\\') {
+                std::fprintf(f, "\\%c", c);
+            } else if (u < 0x20 || u >= 0x7f) {
+                std::fprintf(f, "\\%03o", u);
+            } else {
+                std::fputc(c, f);
+            }
+        }
+        std::fputs("\"\n", f);
+    }
+}
+
+bool write_header(const char* path, const char* source_path, const Catalog& catalog) {
+    std::FILE* f = std::fopen(path, "w");
+    if (f == nullptr) return false;
+    std::fprintf(f, "// Generated by lesson_catalog from %s. Do not edit.\n", source_path);
+    std::fputs("#pragma once\n\n#include <cstdint>\n\n#include \"lesson_catalog.hpp\"\n\n", f);
+    std::fputs("namespace arena {\n\nnamespace lesson_text_en {\n\n", f);
+    std::fprintf(f, "inline constexpr std::uint32_t kCount = %u;\n", arena::kTextCount);
+    std::fprintf(f, "inline constexpr std::uint32_t kNamesHash = 0x%08xu;\n\n", arena::catalog_format::names_hash());
+    std::fputs("inline constexpr std::uint32_t kOffsets[] = {\n", f);
+    for (std::size_t i = 0; i < catalog.offsets.size(); ++i) {
+        std::fprintf(f, "%s%u,%s", i % 8 == 0 ? "    " : " ", catalog.offsets[i],
+                     i % 8 == 7 || i + 1 == catalog.offsets.size() ? "\n" : "");
+    }
+    std::fputs("};\n\ninline constexpr char kStrings[] =\n", f);
+    for (std::uint32_t i = 0; i < arena::kTextCount; ++i) {
+        std::fprintf(f, "    // %s\n", arena::kTextNames[i]);
+        write_literal_lines(f, std::string_view(catalog.strings).substr(
+                                   catalog.offsets[i], catalog.offsets[i + 1] - catalog.offsets[i]));
+    }
+    std::fputs("    \"\";\n\n} // namespace lesson_text_en\n\n", f);
+    std::fputs("static_assert(lesson_text_en::kCount == kTextCount &&\n"
+               "                  lesson_text_en::kNamesHash == catalog_format::names_hash(),\n"
+               "              \"lesson_text_en.hpp is out of date: regenerate it with lesson_catalog --header\");\n\n",
+               f);
+    std::fputs("inline LessonCatalog english_catalog() {\n"
+               "    return LessonCatalog(lesson_text_en::kOffsets, lesson_text_en::kStrings);\n"
+               "}\n\n} // namespace arena\n",
+               f);
+    return std::fclose(f) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        usage();
+        return 1;
+    }
+    const char* source_path = argv[1];
+    std::string_view mode = argv[2];
+    const char* out_path = argv[3];
+    if (mode != "-o" && mode != "--header") {
+        usage();
+        return 1;
+    }
+
+    arena::MappedFile source;
+    if (!source.open(source_path)) {
+        perror(source_path);
+        return 1;
+    }
+    Catalog catalog;
+    if (!compile(source_path, source.view(), catalog)) {
+        return 1;
+    }
+
+    bool ok = mode == "-o" ? write_catalog(out_path, catalog) : write_header(out_path, source_path, catalog);
+    if (!ok) {
+        perror(out_path);
+        return 1;
+    }
+    std::cout << out_path << ": " << arena::kTextCount << " texts, " << catalog.strings.size()
+              << " bytes of text\n";
+    return 0;
+}
@@ -0,0 +1,232 @@
+/*
+    Lesson, hint and heading text for Overflow Arena, looked up by ID.
+
+    The text lives in catalog sources (lessons/en.txt and translations
+    of it) that the lesson_catalog tool compiles into a flat binary
+    catalog: a 24-byte FileHeader, then count + 1 uint32 offsets, then
+    one string table holding every text back to back. Text id spans
+    offsets[id] .. offsets[id + 1], so a lookup is two loads. Headings
+    are rendered by the compiler, so a text is written out as is.
+
+    A LessonCatalog is only a view. English is compiled into the
+    programs (lesson_text_en.hpp, generated by the same tool), and
+    open() maps a catalog file read-only instead, so every process on
+    a host shares one copy of, say, a translated catalog through the
+    page cache and it can be swapped without recompiling.
+
+    Texts may hold {} placeholders, filled in order by print_text(), or
+    {0}..{9} to pick an argument by position when a translation needs
+    a different word order.
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+
+#include "arena_parse.hpp"
+
+// Every text ID. A catalog source defines each one as "@name"; new
+// IDs go at the end, and catalogs must be rebuilt after any change.
+#define ARENA_LESSON_TEXTS(X) \
+    X(welcome)                \
+    X(menu)                   \
+    X(menu_prompt)            \
+    X(menu_invalid)           \
+    X(goodbye)                \
+    X(guess_prompt)           \
+    X(invalid_integer)        \
+    X(input_closed)           \
+    X(wait_for_enter)         \
+    X(bits_intro)             \
+    X(run_result)             \
+    X(reflect)                \
+    X(rules_of_thumb)         \
+    X(micro_lessons)          \
+    X(tour_intro)             \
+    X(tour_int_lesson)        \
+    X(tour_int_explain)       \
+    X(tour_uint_lesson)       \
+    X(tour_uint_explain)      \
+    X(tour_u8_lesson)         \
+    X(tour_u8_explain)        \
+    X(tour_s8_lesson)         \
+    X(tour_s8_run)            \
+    X(tour_s8_explain)        \
+    X(tour_float_lesson)      \
+    X(tour_float_run)         \
+    X(tour_float_explain)     \
+    X(limits_table)           \
+    X(limits_wide)            \
+    X(limits_wide_row)        \
+    X(limits_float_digits)    \
+    X(demo_heading)           \
+    X(demo_unsigned)          \
+    X(demo_signed)            \
+    X(demo_float_inf)         \
+    X(advanced_notes)         \
+    X(pitfalls_lesson)        \
+    X(pitfalls_explain)       \
+    X(arena_intro)            \
+    X(arena_quit)             \
+    X(guess_invalid)          \
+    X(guess_out_of_range)     \
+    X(round_header)           \
+    X(hint_signed)            \
+    X(hint_unsigned)          \
+    X(round_prompt)           \
+    X(round_run)              \
+    X(explain_signed)         \
+    X(explain_unsigned)       \
+    X(round_correct)          \
+    X(round_wrong)            \
+    X(round_score)
+
+namespace arena {
+
+enum class Text : std::uint32_t {
+#define ARENA_LESSON_TEXT_ENUM(name) name,
+    ARENA_LESSON_TEXTS(ARENA_LESSON_TEXT_ENUM)
+#undef ARENA_LESSON_TEXT_ENUM
+    count
+};
+
+constexpr std::uint32_t kTextCount = static_cast<std::uint32_t>(Text::count);
+
+inline constexpr const char* kTextNames[] = {
+#define ARENA_LESSON_TEXT_NAME(name) #name,
+    ARENA_LESSON_TEXTS(ARENA_LESSON_TEXT_NAME)
+#undef ARENA_LESSON_TEXT_NAME
+};
+
+namespace catalog_format {
+
+constexpr char kMagic[8] = {'O', 'A', 'C', 'A', 'T', 'L', 'G', '1'};
+constexpr std::uint32_t kVersion = 1;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t count;        // must be kTextCount
+    std::uint32_t names_hash;   // must be names_hash()
+    std::uint32_t strings_size;
+};
+
+static_assert(sizeof(FileHeader) == 24);
+
+// FNV-1a over the ID names in order, so a catalog built for another
+// set of IDs is rejected even if the count happens to match.
+constexpr std::uint32_t names_hash() {
+    std::uint32_t h = 2166136261u;
+    for (const char* name : kTextNames) {
+        for (const char* p = name; *p != '\0'; ++p) {
+            h = (h ^ static_cast<unsigned char>(*p)) * 16777619u;
+        }
+        h = (h ^ 0u) * 16777619u;
+    }
+    return h;
+}
+
+} // namespace catalog_format
+
+class LessonCatalog {
+public:
+    LessonCatalog() = default;
+    LessonCatalog(const std::uint32_t* offsets, const char* strings)
+        : offsets_(offsets), strings_(strings) {}
+
+    std::string_view operator[](Text id) const {
+        auto i = static_cast<std::uint32_t>(id);
+        return std::string_view(strings_ + offsets_[i], offsets_[i + 1] - offsets_[i]);
+    }
+
+private:
+    const std::uint32_t* offsets_ = nullptr;
+    const char* strings_ = nullptr;
+};
+
+enum class CatalogStatus { ok, io_error, bad_header, wrong_ids, corrupt };
+
+// Maps a compiled catalog file and checks it once, so that lookups
+// through catalog() never need to. Keep it open while the catalog is used.
+class CatalogFile {
+public:
+    CatalogStatus open(const char* path) {
+        catalog_ = LessonCatalog();
+        if (!file_.open(path)) return CatalogStatus::io_error;
+        std::string_view data = file_.view();
+
+        catalog_format::FileHeader header;
+        if (data.size() < sizeof(header)) return CatalogStatus::bad_header;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, catalog_format::kMagic, sizeof(header.magic)) != 0 ||
+            header.version != catalog_format::kVersion) {
+            return CatalogStatus::bad_header;
+        }
+        if (header.count != kTextCount || header.names_hash != catalog_format::names_hash()) {
+            return CatalogStatus::wrong_ids;
+        }
+
+        // mmap returns page-aligned memory and the header is 24 bytes,
+        // so the offsets are suitably aligned in place.
+        std::size_t offsets_size = (std::size_t{kTextCount} + 1) * sizeof(std::uint32_t);
+        if (data.size() != sizeof(header) + offsets_size + header.strings_size) {
+            return CatalogStatus::corrupt;
+        }
+        const auto* offsets = reinterpret_cast<const std::uint32_t*>(data.data() + sizeof(header));
+        if (offsets[0] != 0 || offsets[kTextCount] != header.strings_size) {
+            return CatalogStatus::corrupt;
+        }
+        for (std::uint32_t i = 0; i < kTextCount; ++i) {
+            if (offsets[i] > offsets[i + 1]) return CatalogStatus::corrupt;
+        }
+        catalog_ = LessonCatalog(offsets, data.data() + sizeof(header) + offsets_size);
+        return CatalogStatus::ok;
+    }
+
+    const LessonCatalog& catalog() const { return catalog_; }
+
+private:
+    MappedFile file_;
+    LessonCatalog catalog_;
+};
+
+namespace catalog_detail {
+
+inline void print_arg(std::ostream&, unsigned) {}
+
+template <typename First, typename... Rest>
+void print_arg(std::ostream& out, unsigned index, const First& first, const Rest&... rest) {
+    if (index == 0) {
+        out << first;
+    } else {
+        print_arg(out, index - 1, rest...);
+    }
+}
+
+} // namespace catalog_detail
+
+// Writes `text`, replacing each {} with the next argument and {N} with
+// argument N. Placeholders past the last argument print nothing.
+template <typename... Args>
+void print_text(std::ostream& out, std::string_view text, const Args&... args) {
+    unsigned next = 0;
+    while (true) {
+        std::size_t open = text.find('{');
+        if (open == std::string_view::npos || open + 1 >= text.size()) break;
+        char c = text[open + 1];
+        bool numbered = c >= '0' && c <= '9' && open + 2 < text.size() && text[open + 2] == '}';
+        if (c != '}' && !numbered) {
+            out.write(text.data(), static_cast<std::streamsize>(open + 1));
+            text.remove_prefix(open + 1);
+            continue;
+        }
+        out.write(text.data(), static_cast<std::streamsize>(open));
+        catalog_detail::print_arg(out, numbered ? static_cast<unsigned>(c - '0') : next++, args...);
+        text.remove_prefix(open + (numbered ? 3 : 2));
+    }
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+} // namespace arena
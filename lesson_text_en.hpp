@@ -0,0 +1,331 @@
+// Generated by lesson_catalog from lessons/en.txt. Do not edit.
+#pragma once
+
+#include <cstdint>
+
+#include "lesson_catalog.hpp"
+
+namespace arena {
+
+namespace lesson_text_en {
+
+inline constexpr std::uint32_t kCount = 52;
+inline constexpr std::uint32_t kNamesHash = 0x5cf2b4ccu;
+
+inline constexpr std::uint32_t kOffsets[] = {
+    0, 27, 235, 253, 293, 302, 314, 344,
+    375, 402, 466, 486, 516, 747, 1222, 1302,
+    1465, 1544, 1731, 1818, 1995, 2076, 2299, 2329,
+    2459, 2630, 2677, 2787, 2850, 2927, 2950, 3104,
+    3163, 3227, 3340, 3495, 3685, 3917, 4044, 4180,
+    4213, 4264, 4322, 4364, 4432, 4480, 4550, 4586,
+    4717, 4802, 4819, 4854, 4867,
+};
+
+inline constexpr char kStrings[] =
+    // welcome
+    "Welcome to Overflow Arena!\n"
+    // menu
+    "\n"
+    "Overflow Arena - Main Menu\n"
+    "--------------------------\n"
+    "[1] Quick Tour (learn and predict)\n"
+    "[2] Print All Min/Max Tables + Overflow Demos\n"
+    "[3] Play Overflow Arena (game)\n"
+    "[4] Optional: Advanced Pitfalls\n"
+    "[5] Exit\n"
+    // menu_prompt
+    "Choose an option: "
+    // menu_invalid
+    "\n"
+    "Try again\n"
+    "---------\n"
+    "Please choose 1-5.\n"
+    // goodbye
+    "Goodbye!\n"
+    // guess_prompt
+    "Your guess: "
+    // invalid_integer
+    "Please enter a valid integer.\n"
+    // input_closed
+    "\n"
+    "Input stream closed. Exiting.\n"
+    // wait_for_enter
+    "\n"
+    "Press ENTER to continue..."
+    // bits_intro
+    "If you're curious, here is what it looks like in bits:\n"
+    "{} -> {}\n"
+    // run_result
+    "\n"
+    "Run\n"
+    "---\n"
+    "Result: {}\n"
+    // reflect
+    "\n"
+    "Reflect\n"
+    "-------\n"
+    "You said {}.\n"
+    // rules_of_thumb
+    "\n"
+    "Rules of Thumb\n"
+    "--------------\n"
+    "Use int for most counting.\n"
+    "Use unsigned only when negatives never make sense.\n"
+    "Use int32_t or uint32_t when you need exact sizes.\n"
+    "Use double for most decimals.\n"
+    "Use float when memory or speed is tight.\n"
+    // micro_lessons
+    "\n"
+    "Lesson\n"
+    "------\n"
+    "Integers store whole numbers.\n"
+    "Some can go negative and some cannot.\n"
+    "\n"
+    "Lesson\n"
+    "------\n"
+    "char is 1 byte and stores a small number or a character.\n"
+    "The exact range can vary by system.\n"
+    "\n"
+    "Lesson\n"
+    "------\n"
+    "short, int, long, and long long are bigger buckets.\n"
+    "Bigger buckets hold bigger numbers.\n"
+    "\n"
+    "Lesson\n"
+    "------\n"
+    "Fixed-size types like int32_t always have the same size.\n"
+    "They help when you need exact sizes.\n"
+    "\n"
+    "Lesson\n"
+    "------\n"
+    "float and double store decimals.\n"
+    "double is more precise.\n"
+    // tour_intro
+    "\n"
+    "Quick Tour\n"
+    "----------\n"
+    "Learn \342\206\222 Predict \342\206\222 Run \342\206\222 What happened? \342\206\222 Reflect\n"
+    // tour_int_lesson
+    "\n"
+    "Lesson\n"
+    "------\n"
+    "int is a basic whole-number type.\n"
+    "It can store positive and negative values.\n"
+    "\n"
+    "Prediction\n"
+    "----------\n"
+    "What number prints? (int) Start at 5 and add 2.\n"
+    // tour_int_explain
+    "\n"
+    "What happened?\n"
+    "--------------\n"
+    "int stores whole numbers and can go up or down.\n"
+    // tour_uint_lesson
+    "\n"
+    "Lesson\n"
+    "------\n"
+    "unsigned int stores whole numbers that cannot be negative.\n"
+    "It starts at 0 and goes up.\n"
+    "\n"
+    "Prediction\n"
+    "----------\n"
+    "What number prints? (unsigned int) Start at 5 and subtract 2.\n"
+    // tour_uint_explain
+    "\n"
+    "What happened?\n"
+    "--------------\n"
+    "unsigned int cannot go negative. It stays at 0 or more.\n"
+    // tour_u8_lesson
+    "\n"
+    "Lesson\n"
+    "------\n"
+    "uint8_t is a tiny unsigned bucket.\n"
+    "When it is full, it wraps around and starts over.\n"
+    "\n"
+    "Prediction\n"
+    "----------\n"
+    "What number prints? (uint8_t) Start at 255 and add 1.\n"
+    // tour_u8_explain
+    "\n"
+    "What happened?\n"
+    "--------------\n"
+    "The tiny bucket was full. It wrapped around to 0.\n"
+    // tour_s8_lesson
+    "\n"
+    "Lesson\n"
+    "------\n"
+    "int8_t is a tiny signed bucket.\n"
+    "Signed overflow is not safe to rely on in C++.\n"
+    "We simulate what many computers do so you can learn.\n"
+    "\n"
+    "Prediction\n"
+    "----------\n"
+    "What number prints? (int8_t) Start at 127 and add 1.\n"
+    // tour_s8_run
+    "\n"
+    "Run\n"
+    "---\n"
+    "Simulated result: {}\n"
+    // tour_s8_explain
+    "\n"
+    "What happened?\n"
+    "--------------\n"
+    "We simulated a wrap-around so you can see the idea.\n"
+    "Signed overflow is not safe to rely on in C++.\n"
+    // tour_float_lesson
+    "\n"
+    "Lesson\n"
+    "------\n"
+    "Decimals are stored with limited precision.\n"
+    "double is more precise than float.\n"
+    "\n"
+    "Prediction\n"
+    "----------\n"
+    "Will 0.1f + 0.2f print exactly 0.3? (1 = yes, 0 = no)\n"
+    // tour_float_run
+    "\n"
+    "Run\n"
+    "---\n"
+    "float sum: {}\n"
+    "difference from 0.3: {}\n"
+    // tour_float_explain
+    "\n"
+    "What happened?\n"
+    "--------------\n"
+    "Some decimals cannot be stored exactly.\n"
+    "Small rounding shows up in the result.\n"
+    // limits_table
+    "\n"
+    "Min/Max Table (Required Types)\n"
+    "------------------------------\n"
+    // limits_wide
+    "\n"
+    "128-bit Integers (compiler extension)\n"
+    "-------------------------------------\n"
+    // limits_wide_row
+    "{}\n"
+    "  min: {}\n"
+    "  max: {}\n"
+    // limits_float_digits
+    "\n"
+    "Float precision (digits you can trust)\n"
+    "--------------------------------------\n"
+    "float       digits10: {}\n"
+    "double      digits10: {}\n"
+    "long double digits10: {}\n"
+    // demo_heading
+    "\n"
+    "Overflow Demo (Meets Rubric)\n"
+    "----------------------------\n"
+    // demo_unsigned
+    "Unsigned wrap ({}):\n"
+    "  max is {}\n"
+    "  max + 1 -> {}\n"
+    "  0 - 1   -> {}\n"
+    // demo_signed
+    "Signed overflow (SIMULATED, {}):\n"
+    "  max is {}\n"
+    "  max + 1 -> {} (simulated)\n"
+    "  min is {}\n"
+    "  min - 1 -> {} (simulated)\n"
+    // demo_float_inf
+    "\n"
+    "Floating overflow -> inf\n"
+    "------------------------\n"
+    "float:  max * 2 = {} | isinf? {}\n"
+    "double: max * 2 = {} | isinf? {}\n"
+    "long double: max * 2 = {} | isinf? {}\n"
+    // advanced_notes
+    "\n"
+    "Optional: Advanced Notes\n"
+    "------------------------\n"
+    "char signedness is implementation-defined. is_signed = {}\n"
+    "long double precision is implementation-defined; not necessarily quad precision.\n"
+    // pitfalls_lesson
+    "\n"
+    "Optional: Advanced Pitfalls\n"
+    "---------------------------\n"
+    "These are here only if you want extra detail.\n"
+    "\n"
+    "Lesson\n"
+    "------\n"
+    "Signed and unsigned can surprise you when mixed.\n"
+    "\n"
+    "Prediction\n"
+    "----------\n"
+    "Will (-1 < 1u) be true? (1 = yes, 0 = no)\n"
+    // pitfalls_explain
+    "\n"
+    "What happened?\n"
+    "--------------\n"
+    "C++ converts -1 into a big unsigned number.\n"
+    "That makes it larger than 1u, so the compare flips.\n"
+    // arena_intro
+    "\n"
+    "Overflow Arena\n"
+    "--------------\n"
+    "How to play: guess the result, then see what happens.\n"
+    "Type 'q' to quit after any round.\n"
+    "Session seed: {}\n"
+    // arena_quit
+    "Exiting game. Final score: {}/{}\n"
+    // guess_invalid
+    "\n"
+    "Try again\n"
+    "---------\n"
+    "Please enter a valid integer.\n"
+    // guess_out_of_range
+    "\n"
+    "Try again\n"
+    "---------\n"
+    "Please enter a number from {} to {}.\n"
+    // round_header
+    "\n"
+    "Round {} | Type: {} | Start: {} | Op: {}\n"
+    // hint_signed
+    "Hint: Range is negative to positive; we simulate wrap for learning.\n"
+    // hint_unsigned
+    "Hint: If it goes past max, it starts over at 0.\n"
+    // round_prompt
+    "\n"
+    "Prediction\n"
+    "----------\n"
+    "What number prints? (or q to quit)\n"
+    "Your guess: "
+    // round_run
+    "\n"
+    "Run\n"
+    "---\n"
+    "Result: {}\n"
+    "Range: {} to {}\n"
+    // explain_signed
+    "\n"
+    "What happened?\n"
+    "--------------\n"
+    "Signed overflow is not safe to rely on in C++.\n"
+    "We simulate what many computers do so you can learn.\n"
+    // explain_unsigned
+    "\n"
+    "What happened?\n"
+    "--------------\n"
+    "Unsigned values wrap around when they pass the limit.\n"
+    // round_correct
+    "Result: Correct!\n"
+    // round_wrong
+    "Result: Not quite. You guessed {}.\n"
+    // round_score
+    "Score: {}/{}\n"
+    "";
+
+} // namespace lesson_text_en
+
+static_assert(lesson_text_en::kCount == kTextCount &&
+                  lesson_text_en::kNamesHash == catalog_format::names_hash(),
+              "lesson_text_en.hpp is out of date: regenerate it with lesson_catalog --header");
+
+inline LessonCatalog english_catalog() {
+    return LessonCatalog(lesson_text_en::kOffsets, lesson_text_en::kStrings);
+}
+
+} // namespace arena
@@ -0,0 +1,200 @@
+/*
+    Compile-time min/max/digits10 table for the types Overflow Arena covers.
+
+    kTypeLimits holds the numeric limits of every type printed by
+    print_all_limits(), and find_type_limits() looks one up by name so
+    other code can range-check values without going through iostreams.
+
+    limits_table_text() is the preformatted table, ready for a single
+    write. Integer rows are formatted in a constant expression; the
+    floating-point rows are formatted once on first use with
+    std::to_chars, because floating to_chars is not constexpr.
+*/
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "wide_int.hpp"
+
+namespace arena {
+
+struct TypeLimits {
+    std::string_view name;
+    bool is_integer;
+    bool is_signed;
+    int digits10;
+    std::intmax_t int_min;    // integers only
+    std::uintmax_t int_max;   // integers only
+    long double float_lowest; // floating point only
+    long double float_max;    // floating point only
+};
+
+template <typename T>
+constexpr TypeLimits make_type_limits(std::string_view name) {
+    using Limits = std::numeric_limits<T>;
+    TypeLimits t{name, Limits::is_integer, Limits::is_signed, Limits::digits10, 0, 0, 0.0L, 0.0L};
+    if constexpr (std::is_integral_v<T>) {
+        t.int_min = static_cast<std::intmax_t>(Limits::min());
+        t.int_max = static_cast<std::uintmax_t>(Limits::max());
+    } else {
+        t.float_lowest = static_cast<long double>(Limits::lowest());
+        t.float_max = static_cast<long double>(Limits::max());
+    }
+    return t;
+}
+
+inline constexpr std::array<TypeLimits, 22> kTypeLimits = {
+    make_type_limits<char>("char"),
+    make_type_limits<signed char>("signed char"),
+    make_type_limits<unsigned char>("unsigned char"),
+    make_type_limits<short>("short"),
+    make_type_limits<unsigned short>("unsigned short"),
+    make_type_limits<int>("int"),
+    make_type_limits<unsigned int>("unsigned int"),
+    make_type_limits<long>("long"),
+    make_type_limits<unsigned long>("unsigned long"),
+    make_type_limits<long long>("long long"),
+    make_type_limits<unsigned long long>("unsigned long long"),
+    make_type_limits<std::int8_t>("int8_t"),
+    make_type_limits<std::uint8_t>("uint8_t"),
+    make_type_limits<std::int16_t>("int16_t"),
+    make_type_limits<std::uint16_t>("uint16_t"),
+    make_type_limits<std::int32_t>("int32_t"),
+    make_type_limits<std::uint32_t>("uint32_t"),
+    make_type_limits<std::int64_t>("int64_t"),
+    make_type_limits<std::uint64_t>("uint64_t"),
+    make_type_limits<float>("float"),
+    make_type_limits<double>("double"),
+    make_type_limits<long double>("long double"),
+};
+
+// Returns nullptr for names not in the table.
+constexpr const TypeLimits* find_type_limits(std::string_view name) {
+    for (const TypeLimits& t : kTypeLimits) {
+        if (t.name == name) return &t;
+    }
+    return nullptr;
+}
+
+static_assert(find_type_limits("int8_t")->int_max == 127);
+
+// True if an integer value is representable in the integer type `t`.
+constexpr bool integer_fits(const TypeLimits& t, long long value) {
+    if (!t.is_integer) return false;
+    if (value < 0) return t.is_signed && value >= t.int_min;
+    return static_cast<std::uintmax_t>(value) <= t.int_max;
+}
+
+// __int128 is a compiler extension: std::numeric_limits only knows it
+// in GNU modes, and its limits don't fit intmax_t. These rows come
+// from wide_int instead and are printed outside the main table.
+struct WideTypeLimits {
+    std::string_view name;
+    int bits;
+    bool is_signed;
+    wide_int<256> min_value;
+    wide_int<256> max_value;
+};
+
+constexpr WideTypeLimits make_wide_type_limits(std::string_view name, int bits, bool is_signed) {
+    wide_int<256> half = wide_int<256>::power_of_two(bits - 1);
+    return {name, bits, is_signed, is_signed ? -half : wide_int<256>(),
+            (is_signed ? half : half + half) - wide_int<256>(1)};
+}
+
+inline constexpr std::array<WideTypeLimits, 2> kWideTypeLimits = {
+    make_wide_type_limits("__int128", 128, true),
+    make_wide_type_limits("unsigned __int128", 128, false),
+};
+
+static_assert(kWideTypeLimits[1].max_value + wide_int<256>(1) == wide_int<256>::power_of_two(128));
+
+namespace limits_detail {
+
+constexpr std::size_t kNameWidth = 18;
+constexpr std::size_t kValueWidth = 24;
+constexpr std::size_t kRowSize = kNameWidth + 2 * kValueWidth + 1;
+
+using Row = std::array<char, kRowSize>;
+
+// Writes `value` right-aligned so it ends at `end`.
+constexpr void put_integer(char* end, bool negative, std::uintmax_t magnitude) {
+    do {
+        *--end = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (negative) *--end = '-';
+}
+
+constexpr Row blank_row(std::string_view name) {
+    Row row{};
+    for (char& c : row) c = ' ';
+    for (std::size_t i = 0; i < name.size() && i < kNameWidth; ++i) row[i] = name[i];
+    row[kRowSize - 1] = '\n';
+    return row;
+}
+
+constexpr Row format_integer_row(const TypeLimits& t) {
+    Row row = blank_row(t.name);
+    bool negative = t.int_min < 0;
+    std::uintmax_t min_magnitude = negative ? 0 - static_cast<std::uintmax_t>(t.int_min)
+                                            : static_cast<std::uintmax_t>(t.int_min);
+    put_integer(row.data() + kNameWidth + kValueWidth, negative, min_magnitude);
+    put_integer(row.data() + kNameWidth + 2 * kValueWidth, false, t.int_max);
+    return row;
+}
+
+inline constexpr auto kIntegerRows = [] {
+    std::array<Row, kTypeLimits.size()> rows{};
+    for (std::size_t i = 0; i < kTypeLimits.size(); ++i) {
+        if (kTypeLimits[i].is_integer) rows[i] = format_integer_row(kTypeLimits[i]);
+    }
+    return rows;
+}();
+
+inline void put_float(char* end, long double value) {
+    char buf[kValueWidth];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::scientific, 6);
+    std::size_t len = static_cast<std::size_t>(result.ptr - buf);
+    std::char_traits<char>::copy(end - len, buf, len);
+}
+
+inline Row format_float_row(const TypeLimits& t) {
+    Row row = blank_row(t.name);
+    put_float(row.data() + kNameWidth + kValueWidth, t.float_lowest);
+    put_float(row.data() + kNameWidth + 2 * kValueWidth, t.float_max);
+    return row;
+}
+
+} // namespace limits_detail
+
+// Header line, dashed rule and one row per entry of kTypeLimits.
+inline std::string_view limits_table_text() {
+    using namespace limits_detail;
+    static const std::string text = [] {
+        std::string s;
+        s.reserve((kTypeLimits.size() + 2) * kRowSize);
+        Row header = blank_row("Type");
+        std::string_view min_title = "Min/Lowest";
+        std::string_view max_title = "Max";
+        min_title.copy(header.data() + kNameWidth + kValueWidth - min_title.size(), min_title.size());
+        max_title.copy(header.data() + kNameWidth + 2 * kValueWidth - max_title.size(), max_title.size());
+        s.append(header.data(), header.size());
+        s.append(kRowSize - 1, '-');
+        s.push_back('\n');
+        for (std::size_t i = 0; i < kTypeLimits.size(); ++i) {
+            Row row = kTypeLimits[i].is_integer ? kIntegerRows[i] : format_float_row(kTypeLimits[i]);
+            s.append(row.data(), row.size());
+        }
+        return s;
+    }();
+    return text;
+}
+
+} // namespace arena
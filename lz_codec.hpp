@@ -0,0 +1,194 @@
+/*
+    A small, fast LZ77 block codec in the LZ4 style, with no outside
+    dependency.
+
+    A compressed block is a series of sequences:
+
+        token         high nibble: literal count, low nibble: match
+                      length - 4 (15 in either means more follows as
+                      extra bytes of 255, ended by one below 255)
+        literals      copied as is
+        offset        2 bytes little-endian, 1..65535 back
+        match length  continued from the token, as above
+
+    The last sequence has only literals and ends the block, so a block
+    can be decoded without knowing where it ends. The compressor finds
+    matches through a 4096-entry hash of the next four bytes and skips
+    ahead faster the longer it goes without one. That gives up some ratio
+    for speed, as LZ4 does.
+
+    Blocks are independent (no window across blocks), which is what lets
+    compressed_file.hpp decompress them in parallel.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace fileio {
+
+namespace lz_detail {
+
+constexpr int kHashBits = 12;
+constexpr std::size_t kMinMatch = 4;
+constexpr std::size_t kMaxOffset = 65535;
+
+inline std::uint32_t load32(const unsigned char* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint64_t load64(const unsigned char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint32_t hash(std::uint32_t v) { return (v * 2654435761u) >> (32 - kHashBits); }
+
+// First position from p where p and q (q behind p) differ, or end.
+inline const unsigned char* match_end(const unsigned char* p, const unsigned char* q, const unsigned char* end) {
+    while (end - p >= 8) {
+        std::uint64_t diff = load64(p) ^ load64(q);
+        if (diff != 0) return p + static_cast<std::size_t>(__builtin_ctzll(diff)) / 8;
+        p += 8;
+        q += 8;
+    }
+    while (p < end && *p == *q) {
+        ++p;
+        ++q;
+    }
+    return p;
+}
+
+// Writes the rest of a length that did not fit in its nibble.
+inline unsigned char* put_length(unsigned char* op, std::size_t n) {
+    while (n >= 255) {
+        *op++ = 255;
+        n -= 255;
+    }
+    *op++ = static_cast<unsigned char>(n);
+    return op;
+}
+
+// Reads the rest of a length; false if the input runs out.
+inline bool get_length(const unsigned char*& ip, const unsigned char* end, std::size_t& n) {
+    while (true) {
+        if (ip >= end) return false;
+        unsigned char b = *ip++;
+        n += b;
+        if (b != 255) return true;
+    }
+}
+
+inline unsigned char* put_sequence(unsigned char* op, const unsigned char* literals, std::size_t literal_count,
+                                   std::size_t offset, std::size_t match_length) {
+    std::size_t extra_match = match_length - kMinMatch;
+    unsigned char* token = op++;
+    *token = static_cast<unsigned char>((literal_count >= 15 ? 15 : literal_count) << 4);
+    if (literal_count >= 15) op = put_length(op, literal_count - 15);
+    if (literal_count > 0) std::memcpy(op, literals, literal_count);
+    op += literal_count;
+    if (match_length == 0) return op; // final literals
+    *op++ = static_cast<unsigned char>(offset);
+    *op++ = static_cast<unsigned char>(offset >> 8);
+    *token |= static_cast<unsigned char>(extra_match >= 15 ? 15 : extra_match);
+    if (extra_match >= 15) op = put_length(op, extra_match - 15);
+    return op;
+}
+
+} // namespace lz_detail
+
+// Largest compressed size for `n` input bytes.
+constexpr std::size_t lz_bound(std::size_t n) { return n + n / 255 + 16; }
+
+// Compresses src[0, n) into dst, which must hold lz_bound(n) bytes.
+// Returns the compressed size.
+inline std::size_t lz_compress(const void* src, std::size_t n, void* dst) {
+    using namespace lz_detail;
+    const auto* in = static_cast<const unsigned char*>(src);
+    auto* op = static_cast<unsigned char*>(dst);
+    const unsigned char* anchor = in;
+    const unsigned char* end = in + n;
+
+    std::uint32_t table[1u << kHashBits] = {};
+    const unsigned char* ip = n > 0 ? in + 1 : in;
+    std::size_t misses = 0;
+    while (ip + kMinMatch <= end) {
+        std::uint32_t seq = load32(ip);
+        std::uint32_t h = hash(seq);
+        const unsigned char* ref = in + table[h];
+        table[h] = static_cast<std::uint32_t>(ip - in);
+        if (ref >= ip || static_cast<std::size_t>(ip - ref) > kMaxOffset || load32(ref) != seq) {
+            ip += 1 + (misses++ >> 5);
+            continue;
+        }
+        misses = 0;
+        // Extend backwards over literals that also match, then forwards.
+        while (ip > anchor && ref > in && ip[-1] == ref[-1]) {
+            --ip;
+            --ref;
+        }
+        const unsigned char* p = match_end(ip + kMinMatch, ref + kMinMatch, end);
+        op = put_sequence(op, anchor, static_cast<std::size_t>(ip - anchor), static_cast<std::size_t>(ip - ref),
+                          static_cast<std::size_t>(p - ip));
+        ip = p;
+        anchor = ip;
+        if (ip + kMinMatch <= end) {
+            // Seed the table inside the match so the next one can chain.
+            table[hash(load32(ip - 2))] = static_cast<std::uint32_t>(ip - 2 - in);
+        }
+    }
+    op = lz_detail::put_sequence(op, anchor, static_cast<std::size_t>(end - anchor), 0, 0);
+    return static_cast<std::size_t>(op - static_cast<unsigned char*>(dst));
+}
+
+// Decompresses a block into dst[0, capacity). Returns the decompressed
+// size, or -1 if the block is malformed or does not fit.
+inline std::ptrdiff_t lz_decompress(const void* src, std::size_t n, void* dst, std::size_t capacity) {
+    using namespace lz_detail;
+    const auto* ip = static_cast<const unsigned char*>(src);
+    const unsigned char* end = ip + n;
+    auto* out = static_cast<unsigned char*>(dst);
+    unsigned char* op = out;
+    unsigned char* out_end = out + capacity;
+
+    while (true) {
+        if (ip >= end) return -1;
+        unsigned token = *ip++;
+        std::size_t literals = token >> 4;
+        if (literals == 15 && !get_length(ip, end, literals)) return -1;
+        if (literals > static_cast<std::size_t>(end - ip) || literals > static_cast<std::size_t>(out_end - op)) {
+            return -1;
+        }
+        if (literals > 0) std::memcpy(op, ip, literals);
+        op += literals;
+        ip += literals;
+        if (ip == end) return op - out; // the final sequence
+
+        if (end - ip < 2) return -1;
+        std::size_t offset = ip[0] | static_cast<std::size_t>(ip[1]) << 8;
+        ip += 2;
+        std::size_t length = token & 15;
+        if (length == 15 && !get_length(ip, end, length)) return -1;
+        length += kMinMatch;
+        if (offset == 0 || offset > static_cast<std::size_t>(op - out) ||
+            length > static_cast<std::size_t>(out_end - op)) {
+            return -1;
+        }
+        // Copy in growing chunks: each one repeats the bytes already
+        // written, so short offsets (runs) still copy with memcpy.
+        const unsigned char* from = op - offset;
+        while (length > 0) {
+            std::size_t chunk = static_cast<std::size_t>(op - from);
+            if (chunk > length) chunk = length;
+            std::memcpy(op, from, chunk);
+            op += chunk;
+            length -= chunk;
+        }
+    }
+}
+
+} // namespace fileio
@@ -0,0 +1,147 @@
+/*
+    Bounded lock-free queue for many producers and many consumers
+    (Dmitry Vyukov's array queue).
+
+    Every cell carries a sequence number that says whose turn it is: a
+    producer may fill cell i when its sequence equals the ticket it
+    claimed, a consumer may empty it when the sequence is one past that.
+    Producers and consumers only contend on their own end's counter,
+    and a full or empty queue is reported instead of waited on, so
+    callers decide whether to spin, sleep or drop.
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "sharded_counter.hpp"
+
+template <typename T>
+class MpmcQueue {
+public:
+    // Capacity is rounded up to a power of two.
+    explicit MpmcQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) size *= 2;
+        mask_ = size - 1;
+        cells_ = std::make_unique<Cell[]>(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    // False if the queue is full; `value` is left untouched then.
+    bool try_push(T& value) {
+        std::size_t pos = tail_.value.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (tail_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // False if the queue is empty.
+    bool try_pop(T& out) {
+        std::size_t pos = head_.value.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (head_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.value);
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Claimed pushes minus claimed pops; only a snapshot while other
+    // threads are running.
+    std::size_t size_approx() const {
+        std::size_t head = head_.value.load(std::memory_order_acquire);
+        std::size_t tail = tail_.value.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    struct alignas(kCacheLineSize) Counter {
+        std::atomic<std::size_t> value{0};
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_ = 0;
+    Counter head_;
+    Counter tail_;
+};
+
+// Lets threads sleep until a lock-free structure has work for them,
+// without a lock or syscall on the notify side while nobody sleeps.
+class Parking {
+public:
+    template <typename Ready>
+    void wait(Ready ready) {
+        if (ready()) return;
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        // Pairs with the fence in notify: either the notifier sees this
+        // sleeper, or ready() sees what the notifier published.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        cv_.wait(lock, ready);
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify_one() {
+        if (has_sleepers()) {
+            { std::lock_guard<std::mutex> lock(mutex_); }
+            cv_.notify_one();
+        }
+    }
+
+    void notify_all() {
+        if (has_sleepers()) {
+            { std::lock_guard<std::mutex> lock(mutex_); }
+            cv_.notify_all();
+        }
+    }
+
+private:
+    bool has_sleepers() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return sleepers_.load(std::memory_order_relaxed) > 0;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<int> sleepers_{0};
+};
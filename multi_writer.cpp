@@ -0,0 +1,228 @@
+/*
+    Exporter-style benchmark for write_service.hpp.
+
+    Writes the same set of files twice: first one after another from
+    the main thread, the way HW1_4 writes part3.txt (open, write()
+    BUFFER-sized chunks, close), then through a WriteService fed by
+    several producer threads. Files are spread round-robin over the
+    given directories; put them on different disks to see the pool
+    grow. Prints throughput for both runs plus the service's thread
+    count and queue depth. With -c the service also writes a CRC32C
+    sidecar per file (check them with crc_verify).
+
+    Files hold synthetic data from data_gen.hpp (-d, random by default;
+    -d a gives HW1_4's buffer of 'A's). File i is bytes
+    [i * size, (i + 1) * size) of one stream, so both runs write the
+    same bytes and make them at the same cost.
+
+    Build: g++ -std=c++17 -O2 -pthread multi_writer.cpp -o multi_writer
+    Usage: multi_writer [-n files] [-s bytes] [-b buffer] [-p producers]
+                        [-t threads_per_device] [-q queue] [-c block]
+                        [-d random|text|a|PERCENT] [dir ...]
+           Defaults: 2000 files of 128 KiB, the block-size-based buffer
+           HW1_4 recommends, 2 producers, 4 threads per device, a
+           1024-job queue per device, and the current directory.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+#include "arena_parse.hpp"
+#include "data_gen.hpp"
+#include "write_service.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+    std::uint64_t files = 2000;
+    std::uint64_t file_size = 128 * 1024;
+    std::uint64_t buffer_size = 0; // 0: 8 filesystem blocks, as HW1_4 suggests
+    unsigned producers = 2;
+    unsigned threads_per_device = 4;
+    std::uint64_t queue = 1024;
+    std::uint32_t checksum_block = 0;
+    fileio::DataSpec data;
+    std::vector<std::string> dirs;
+};
+
+void usage() {
+    std::cerr << "usage: multi_writer [-n files] [-s bytes] [-b buffer] [-p producers]\n"
+                 "                    [-t threads_per_device] [-q queue] [-c block]\n"
+                 "                    [-d random|text|a|PERCENT] [dir ...]\n";
+}
+
+std::string file_path(const Config& config, std::uint64_t i) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/export-%06llu.dat", static_cast<unsigned long long>(i));
+    return config.dirs[i % config.dirs.size()] + name;
+}
+
+// The HW1_4 loop, once per file. The block is refilled before every
+// write so both runs produce their data. Returns false after perror().
+bool write_sequential(const Config& config, const fileio::DataGenerator& data, std::vector<char>& block) {
+    for (std::uint64_t i = 0; i < config.files; ++i) {
+        std::string path = file_path(config, i);
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            perror(path.c_str());
+            return false;
+        }
+        for (std::uint64_t done = 0; done < config.file_size;) {
+            std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(block.size(), config.file_size - done));
+            data.fill(i * config.file_size + done, block.data(), n);
+            ssize_t bytes = write(fd, block.data(), n);
+            if (bytes < 0) {
+                perror("write");
+                close(fd);
+                return false;
+            }
+            done += static_cast<std::uint64_t>(bytes);
+        }
+        if (close(fd) != 0) {
+            perror("close");
+            return false;
+        }
+    }
+    return true;
+}
+
+void produce(const Config& config, const fileio::DataGenerator& data, fileio::BufferPool& pool,
+             fileio::WriteService& service, std::atomic<std::uint64_t>& next_file) {
+    while (true) {
+        std::uint64_t i = next_file.fetch_add(1, std::memory_order_relaxed);
+        if (i >= config.files) return;
+
+        fileio::WriteJob job;
+        job.path = file_path(config, i);
+        fileio::Buffer** tail = &job.data;
+        for (std::uint64_t left = config.file_size; left > 0;) {
+            fileio::Buffer* b = pool.acquire();
+            b->size = static_cast<std::size_t>(std::min<std::uint64_t>(pool.buffer_size(), left));
+            data.fill(i * config.file_size + (config.file_size - left), b->data, b->size);
+            left -= b->size;
+            *tail = b;
+            tail = &b->next;
+        }
+        service.submit(std::move(job));
+    }
+}
+
+double mb_per_second(std::uint64_t bytes, double seconds) {
+    return seconds > 0 ? static_cast<double>(bytes) / seconds / 1e6 : 0;
+}
+
+bool parse_option(const char* text, std::uint64_t& value, std::uint64_t min) {
+    return arena::parse_int(text, value, min, std::numeric_limits<std::uint64_t>::max()) ==
+           arena::ParseStatus::ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config config;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool has_value = i + 1 < argc;
+        bool ok = true;
+        if (arg == "-n" && has_value) {
+            ok = parse_option(argv[++i], config.files, 1);
+        } else if (arg == "-s" && has_value) {
+            ok = parse_option(argv[++i], config.file_size, 0);
+        } else if (arg == "-b" && has_value) {
+            ok = parse_option(argv[++i], config.buffer_size, 1);
+        } else if (arg == "-q" && has_value) {
+            ok = parse_option(argv[++i], config.queue, 2);
+        } else if (arg == "-c" && has_value) {
+            ok = arena::parse_int(argv[++i], config.checksum_block, 1u, 1u << 30) == arena::ParseStatus::ok;
+        } else if (arg == "-d" && has_value) {
+            ok = fileio::parse_data_spec(argv[++i], config.data);
+        } else if (arg == "-p" && has_value) {
+            ok = arena::parse_int(argv[++i], config.producers, 1u, 256u) == arena::ParseStatus::ok;
+        } else if (arg == "-t" && has_value) {
+            ok = arena::parse_int(argv[++i], config.threads_per_device, 1u, 256u) == arena::ParseStatus::ok;
+        } else if (!arg.empty() && arg[0] == '-') {
+            ok = false;
+        } else {
+            config.dirs.emplace_back(arg);
+        }
+        if (!ok) {
+            usage();
+            return 1;
+        }
+    }
+    if (config.dirs.empty()) config.dirs.emplace_back(".");
+
+    if (config.buffer_size == 0) {
+        struct statvfs info;
+        config.buffer_size = statvfs(config.dirs[0].c_str(), &info) == 0 ? info.f_bsize * 8 : 32 * 1024;
+    }
+    std::uint64_t total_bytes = config.files * config.file_size;
+
+    fileio::DataGenerator data(config.data);
+    std::vector<char> block(static_cast<std::size_t>(config.buffer_size));
+    auto t0 = Clock::now();
+    if (!write_sequential(config, data, block)) return 1;
+    double sequential_seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    // Enough buffers for every producer to fill a file while the
+    // writers and a full queue of jobs hold two more files' worth each.
+    std::uint64_t per_file = std::max<std::uint64_t>((config.file_size + config.buffer_size - 1) / config.buffer_size, 1);
+    fileio::WriteService::Options options;
+    options.directories = config.dirs;
+    options.threads_per_device = config.threads_per_device;
+    options.queue_capacity = static_cast<std::size_t>(config.queue);
+    options.checksum_block = config.checksum_block;
+    std::size_t devices = std::max<std::size_t>(fileio::count_devices(config.dirs), 1);
+    std::uint64_t pool_files = config.producers + 2 * devices * config.threads_per_device;
+    fileio::BufferPool pool(static_cast<std::size_t>(pool_files * per_file), static_cast<std::size_t>(config.buffer_size));
+
+    fileio::WriteService service(pool, options);
+    std::atomic<std::uint64_t> next_file{0};
+    std::vector<std::thread> producers;
+    for (unsigned i = 0; i < config.producers; ++i) {
+        producers.emplace_back(produce, std::cref(config), std::cref(data), std::ref(pool), std::ref(service),
+                               std::ref(next_file));
+    }
+    for (std::thread& t : producers) t.join();
+    service.close();
+    fileio::WriteStats stats = service.stats();
+
+    if (stats.jobs_failed > 0) {
+        std::cerr << "multi_writer: " << stats.jobs_failed << " files failed: " << std::strerror(stats.first_errno)
+                  << "\n";
+        return 1;
+    }
+
+    std::cout << config.files << " files x " << config.file_size << " bytes (" << std::fixed << std::setprecision(1)
+              << static_cast<double>(total_bytes) / 1e6 << " MB) in " << config.dirs.size() << " dir(s), "
+              << pool.buffer_size() << "-byte buffers, " << fileio::describe(config.data) << " data\n";
+    std::cout << "sequential:  " << std::setprecision(3) << sequential_seconds << " s, " << std::setprecision(1)
+              << mb_per_second(total_bytes, sequential_seconds) << " MB/s, "
+              << static_cast<double>(config.files) / sequential_seconds << " files/s\n";
+    std::cout << "service:     " << std::setprecision(3) << stats.seconds << " s, " << std::setprecision(1)
+              << stats.mb_per_second() << " MB/s, " << stats.jobs_per_second() << " files/s\n";
+    std::cout << "             " << service.devices() << " device(s) x " << config.threads_per_device << " = "
+              << service.threads() << " writers, " << config.producers << " producers, max queue depth "
+              << stats.max_queue_depth << "/" << service.queue_capacity() << " per device\n";
+    if (config.checksum_block != 0) {
+        std::cout << "             CRC32C sidecars per " << config.checksum_block << " bytes ("
+                  << (fileio::crc32c_hw_available() ? "SSE4.2" : "table") << ")\n";
+    }
+    return 0;
+}
@@ -1,628 +1,437 @@
-#include <bitset>
 #include <cstdint>
 #include <cstdlib>
-#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <optional>
 #include <random>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 #include <cmath> // std::isinf
+#include <csignal>
+#include <cstdio>
+
+#include <signal.h>
+#include <unistd.h>
+
+#include "arena_core.hpp"
+#include "arena_flow.hpp"
+#include "arena_leaderboard.hpp"
+#include "arena_log.hpp"
+#include "arena_memory.hpp"
+#include "arena_metrics.hpp"
+#include "arena_output.hpp"
+#include "arena_parse.hpp"
+#include "arena_session.hpp"
+#include "arith.hpp"
+#include "lesson_catalog.hpp"
+#include "lesson_text_en.hpp"
+#include "limits_table.hpp"
 
 namespace {
 
-void print_heading(const std::string& title) {
-    std::cout << "\n" << title << "\n";
-    std::cout << std::string(title.size(), '-') << "\n";
+using arena::binary_from_signed;
+using arena::to_binary_string;
+using arena::wrap_signed;
+
+// Seed for every arena game when --seed is given; otherwise each game
+// draws a fresh one. The seed is printed so sessions can be replayed.
+bool g_fixed_seed = false;
+std::uint32_t g_seed = 0;
+
+// Binary round log, opened when --log is given.
+arena::RoundLogWriter g_round_log;
+
+// Shared leaderboard, opened when --board is given. This process holds
+// one slot for all of its games; arena_top shows the board.
+arena::Leaderboard g_board;
+arena::LeaderboardSlot g_board_slot;
+
+// Scratch for arena rounds, and for the coroutine frames of whichever
+// lesson is running; the menu resets the lesson arena between lessons.
+arena::RoundArena g_round_arena;
+arena::RoundArena g_lesson_arena(16 * 1024);
+
+// Lesson text; English unless --catalog maps a compiled catalog.
+arena::LessonCatalog g_text = arena::english_catalog();
+arena::CatalogFile g_catalog_file;
+
+// Set by SIGINT/SIGTERM. The handler is installed without SA_RESTART,
+// so a read blocked on stdin returns and main() closes the round log.
+volatile std::sig_atomic_t g_stop = 0;
+
+void on_signal(int) { g_stop = 1; }
+
+using arena::Text;
+
+template <typename... Args>
+void say(std::ostream& out, Text id, const Args&... args) {
+    arena::print_text(out, g_text[id], args...);
 }
 
-void wait_for_enter() {
-    std::cout << "\nPress ENTER to continue...";
-    std::cout.flush();
-    std::string line;
-    std::getline(std::cin, line);
+arena::Task<> wait_for_enter(arena::FlowIo& io) {
+    say(io.out, Text::wait_for_enter);
+    co_await io.in.next_line();
 }
 
-int read_int_from_user(const std::string& prompt) {
+arena::Task<int> read_int_from_user(arena::FlowIo& io, std::string_view prompt) {
     while (true) {
-        std::cout << prompt;
-        std::string line;
-        if (!std::getline(std::cin, line)) {
-            std::cout << "\nInput stream closed. Exiting.\n";
-            std::exit(0);
+        io.out << prompt;
+        std::optional<std::string_view> line = co_await io.in.next_line();
+        if (!line) {
+            say(io.out, Text::input_closed);
+            co_await io.in.hang_up();
         }
-        std::stringstream ss(line);
         int value = 0;
-        char extra = '\0';
-        if (ss >> value && !(ss >> extra)) {
-            return value;
+        arena::ParseStatus status = arena::parse_int(*line, value,
+                                                     std::numeric_limits<int>::min(),
+                                                     std::numeric_limits<int>::max());
+        if (status == arena::ParseStatus::ok) {
+            co_return value;
         }
-        std::cout << "Please enter a valid integer.\n";
+        say(io.out, Text::invalid_integer);
     }
 }
 
-template <typename T>
-void print_limits(const std::string& name) {
-    using Limits = std::numeric_limits<T>;
-    std::ios::fmtflags old_flags = std::cout.flags();
-    std::streamsize old_precision = std::cout.precision();
-
-    std::cout << std::left << std::setw(18) << name
-              << std::right << std::setw(24);
-
-    if constexpr (std::is_floating_point_v<T>) {
-        std::cout << std::scientific << std::setprecision(6)
-                  << static_cast<long double>(Limits::lowest());
-    } else if constexpr (std::is_integral_v<T>) {
-        if constexpr (Limits::is_signed) {
-            std::cout << static_cast<std::intmax_t>(Limits::min());
-        } else {
-            std::cout << static_cast<std::uintmax_t>(Limits::min());
-        }
-    }
+void show_rules_of_thumb(std::ostream& out) {
+    say(out, Text::rules_of_thumb);
+}
 
-    std::cout << std::setw(24);
-    if constexpr (std::is_floating_point_v<T>) {
-        std::cout << std::scientific << std::setprecision(6)
-                  << static_cast<long double>(Limits::max());
-    } else if constexpr (std::is_integral_v<T>) {
-        if constexpr (Limits::is_signed) {
-            std::cout << static_cast<std::intmax_t>(Limits::max());
-        } else {
-            std::cout << static_cast<std::uintmax_t>(Limits::max());
-        }
-    }
+arena::Task<> show_micro_lessons(arena::FlowIo& io) {
+    std::ostream& out = io.out;
+    say(out, Text::micro_lessons);
 
-    std::cout << "\n";
-    std::cout.flags(old_flags);
-    std::cout.precision(old_precision);
+    show_rules_of_thumb(out);
+    co_await wait_for_enter(io);
 }
 
-template <typename T>
-std::string to_binary_string(T value) {
-    using UnsignedT = std::make_unsigned_t<T>;
-    UnsignedT bits = static_cast<UnsignedT>(value);
-    if constexpr (sizeof(UnsignedT) == 1) {
-        return std::bitset<8>(bits).to_string();
-    } else if constexpr (sizeof(UnsignedT) == 2) {
-        return std::bitset<16>(bits).to_string();
-    } else if constexpr (sizeof(UnsignedT) == 4) {
-        return std::bitset<32>(bits).to_string();
-    } else {
-        return std::bitset<64>(bits).to_string();
-    }
-}
+arena::Task<> quick_tour(arena::FlowIo& io) {
+    std::ostream& out = io.out;
+    say(out, Text::tour_intro);
 
-std::string binary_from_signed(long long value, int bits) {
-    unsigned long long mask = (bits == 64) ? std::numeric_limits<unsigned long long>::max()
-                                           : ((1ULL << bits) - 1ULL);
-    unsigned long long uvalue = static_cast<unsigned long long>(value) & mask;
-    if (bits == 8) return std::bitset<8>(uvalue).to_string();
-    if (bits == 16) return std::bitset<16>(uvalue).to_string();
-    if (bits == 32) return std::bitset<32>(uvalue).to_string();
-    return std::bitset<64>(uvalue).to_string();
-}
+    say(out, Text::tour_int_lesson);
+    int guess1 = co_await read_int_from_user(io, g_text[Text::guess_prompt]);
 
-long long wrap_unsigned(long long value, int bits) {
-    if (bits == 64) {
-        return static_cast<unsigned long long>(value);
-    }
-    if (bits < 1 || bits > 63) {
-        return value;
+    {
+        ARENA_TIME_SCOPE(tour_run);
+        int int_value = 5;
+        int_value += 2;
+        say(out, Text::run_result, int_value);
     }
-    unsigned long long mod = (1ULL << bits);
-    unsigned long long uvalue = static_cast<unsigned long long>(value);
-    unsigned long long wrapped = uvalue % mod;
-    return static_cast<long long>(wrapped);
-}
 
-// FIXED: correct for negative inputs; avoids UB; uses safe modulo + sign conversion
-long long wrap_signed(long long value, int bits) {
-    if (bits < 1 || bits > 63) {
-        return value;
-    }
+    say(out, Text::tour_int_explain);
+    say(out, Text::reflect, guess1);
 
-    const unsigned long long mod = (1ULL << bits);
+    say(out, Text::tour_uint_lesson);
+    int guess2 = co_await read_int_from_user(io, g_text[Text::guess_prompt]);
 
-    long long wrapped = value % static_cast<long long>(mod);
-    if (wrapped < 0) {
-        wrapped += static_cast<long long>(mod);
+    {
+        ARENA_TIME_SCOPE(tour_run);
+        unsigned int uint_value = 5u;
+        uint_value -= 2u;
+        say(out, Text::run_result, uint_value);
     }
 
-    const long long sign_bit = 1LL << (bits - 1);
-    if (wrapped & sign_bit) {
-        wrapped -= static_cast<long long>(mod);
+    say(out, Text::tour_uint_explain);
+    say(out, Text::reflect, guess2);
+
+    say(out, Text::tour_u8_lesson);
+    int guess3 = co_await read_int_from_user(io, g_text[Text::guess_prompt]);
+
+    {
+        ARENA_TIME_SCOPE(tour_run);
+        std::uint8_t u8max = std::numeric_limits<std::uint8_t>::max();
+        std::uint8_t u8wrap = static_cast<std::uint8_t>(static_cast<unsigned int>(u8max) + 1u);
+        say(out, Text::run_result, static_cast<int>(u8wrap));
+        say(out, Text::bits_intro, to_binary_string(u8max), to_binary_string(u8wrap));
     }
-    return wrapped;
-}
 
-void show_rules_of_thumb() {
-    print_heading("Rules of Thumb");
-    std::cout << "Use int for most counting.\n";
-    std::cout << "Use unsigned only when negatives never make sense.\n";
-    std::cout << "Use int32_t or uint32_t when you need exact sizes.\n";
-    std::cout << "Use double for most decimals.\n";
-    std::cout << "Use float when memory or speed is tight.\n";
-}
+    say(out, Text::tour_u8_explain);
+    say(out, Text::reflect, guess3);
+
+    say(out, Text::tour_s8_lesson);
+    int guess4 = co_await read_int_from_user(io, g_text[Text::guess_prompt]);
 
-void show_micro_lessons() {
-    print_heading("Lesson");
-    std::cout << "Integers store whole numbers.\n";
-    std::cout << "Some can go negative and some cannot.\n";
+    {
+        ARENA_TIME_SCOPE(tour_run);
+        std::int8_t s8max = std::numeric_limits<std::int8_t>::max();
+        long long wide_before = static_cast<long long>(s8max);
+        long long wide_after = wide_before + 1;
+        long long wrapped = wrap_signed(wide_after, 8);
+        std::int8_t converted = static_cast<std::int8_t>(wrapped);
+        say(out, Text::tour_s8_run, static_cast<int>(converted));
+        say(out, Text::bits_intro, binary_from_signed(s8max, 8), binary_from_signed(converted, 8));
+    }
 
-    print_heading("Lesson");
-    std::cout << "char is 1 byte and stores a small number or a character.\n";
-    std::cout << "The exact range can vary by system.\n";
+    say(out, Text::tour_s8_explain);
+    say(out, Text::reflect, guess4);
 
-    print_heading("Lesson");
-    std::cout << "short, int, long, and long long are bigger buckets.\n";
-    std::cout << "Bigger buckets hold bigger numbers.\n";
+    say(out, Text::tour_float_lesson);
+    int guess5 = co_await read_int_from_user(io, g_text[Text::guess_prompt]);
 
-    print_heading("Lesson");
-    std::cout << "Fixed-size types like int32_t always have the same size.\n";
-    std::cout << "They help when you need exact sizes.\n";
+    {
+        ARENA_TIME_SCOPE(tour_run);
+        float fsum = 0.1f + 0.2f;
+        double diff = static_cast<double>(fsum) - 0.3;
+
+        std::ios::fmtflags old_flags = out.flags();
+        std::streamsize old_precision = out.precision();
+        out << std::fixed << std::setprecision(12);
+        say(out, Text::tour_float_run, fsum, diff);
+        out.flags(old_flags);
+        out.precision(old_precision);
+    }
 
-    print_heading("Lesson");
-    std::cout << "float and double store decimals.\n";
-    std::cout << "double is more precise.\n";
+    say(out, Text::tour_float_explain);
+    say(out, Text::reflect, guess5);
 
-    show_rules_of_thumb();
-    wait_for_enter();
+    co_await wait_for_enter(io);
 }
 
-void quick_tour() {
-    print_heading("Quick Tour");
-    std::cout << "Learn \u2192 Predict \u2192 Run \u2192 What happened? \u2192 Reflect\n";
-
-    print_heading("Lesson");
-    std::cout << "int is a basic whole-number type.\n";
-    std::cout << "It can store positive and negative values.\n";
-
-    print_heading("Prediction");
-    std::cout << "What number prints? (int) Start at 5 and add 2.\n";
-    int guess1 = read_int_from_user("Your guess: ");
-
-    print_heading("Run");
-    int int_value = 5;
-    int_value += 2;
-    std::cout << "Result: " << int_value << "\n";
-
-    print_heading("What happened?");
-    std::cout << "int stores whole numbers and can go up or down.\n";
-
-    print_heading("Reflect");
-    std::cout << "You said " << guess1 << ".\n";
-
-    print_heading("Lesson");
-    std::cout << "unsigned int stores whole numbers that cannot be negative.\n";
-    std::cout << "It starts at 0 and goes up.\n";
-
-    print_heading("Prediction");
-    std::cout << "What number prints? (unsigned int) Start at 5 and subtract 2.\n";
-    int guess2 = read_int_from_user("Your guess: ");
-
-    print_heading("Run");
-    unsigned int uint_value = 5u;
-    uint_value -= 2u;
-    std::cout << "Result: " << uint_value << "\n";
-
-    print_heading("What happened?");
-    std::cout << "unsigned int cannot go negative. It stays at 0 or more.\n";
-
-    print_heading("Reflect");
-    std::cout << "You said " << guess2 << ".\n";
-
-    print_heading("Lesson");
-    std::cout << "uint8_t is a tiny unsigned bucket.\n";
-    std::cout << "When it is full, it wraps around and starts over.\n";
-
-    print_heading("Prediction");
-    std::cout << "What number prints? (uint8_t) Start at 255 and add 1.\n";
-    int guess3 = read_int_from_user("Your guess: ");
-
-    print_heading("Run");
-    std::uint8_t u8max = std::numeric_limits<std::uint8_t>::max();
-    std::uint8_t u8wrap = static_cast<std::uint8_t>(static_cast<unsigned int>(u8max) + 1u);
-    std::cout << "Result: " << static_cast<int>(u8wrap) << "\n";
-    std::cout << "If you're curious, here is what it looks like in bits:\n";
-    std::cout << to_binary_string(u8max) << " -> " << to_binary_string(u8wrap) << "\n";
-
-    print_heading("What happened?");
-    std::cout << "The tiny bucket was full. It wrapped around to 0.\n";
-
-    print_heading("Reflect");
-    std::cout << "You said " << guess3 << ".\n";
-
-    print_heading("Lesson");
-    std::cout << "int8_t is a tiny signed bucket.\n";
-    std::cout << "Signed overflow is not safe to rely on in C++.\n";
-    std::cout << "We simulate what many computers do so you can learn.\n";
-
-    print_heading("Prediction");
-    std::cout << "What number prints? (int8_t) Start at 127 and add 1.\n";
-    int guess4 = read_int_from_user("Your guess: ");
-
-    print_heading("Run");
-    std::int8_t s8max = std::numeric_limits<std::int8_t>::max();
-    long long wide_before = static_cast<long long>(s8max);
-    long long wide_after = wide_before + 1;
-    long long wrapped = wrap_signed(wide_after, 8);
-    std::int8_t converted = static_cast<std::int8_t>(wrapped);
-    std::cout << "Simulated result: " << static_cast<int>(converted) << "\n";
-    std::cout << "If you're curious, here is what it looks like in bits:\n";
-    std::cout << binary_from_signed(s8max, 8) << " -> " << binary_from_signed(converted, 8) << "\n";
-
-    print_heading("What happened?");
-    std::cout << "We simulated a wrap-around so you can see the idea.\n";
-    std::cout << "Signed overflow is not safe to rely on in C++.\n";
-
-    print_heading("Reflect");
-    std::cout << "You said " << guess4 << ".\n";
-
-    print_heading("Lesson");
-    std::cout << "Decimals are stored with limited precision.\n";
-    std::cout << "double is more precise than float.\n";
-
-    print_heading("Prediction");
-    std::cout << "Will 0.1f + 0.2f print exactly 0.3? (1 = yes, 0 = no)\n";
-    int guess5 = read_int_from_user("Your guess: ");
-
-    print_heading("Run");
-    float fsum = 0.1f + 0.2f;
-    double diff = static_cast<double>(fsum) - 0.3;
-
-    std::ios::fmtflags old_flags = std::cout.flags();
-    std::streamsize old_precision = std::cout.precision();
-    std::cout << std::fixed << std::setprecision(12);
-    std::cout << "float sum: " << fsum << "\n";
-    std::cout << "difference from 0.3: " << diff << "\n";
-    std::cout.flags(old_flags);
-    std::cout.precision(old_precision);
-
-    print_heading("What happened?");
-    std::cout << "Some decimals cannot be stored exactly.\n";
-    std::cout << "Small rounding shows up in the result.\n";
-
-    print_heading("Reflect");
-    std::cout << "You said " << guess5 << ".\n";
-
-    wait_for_enter();
+// Unsigned wrap (defined behavior)
+template <typename T>
+void show_unsigned_wrap(std::ostream& out, const char* name) {
+    T max_value = std::numeric_limits<T>::max();
+    T over = static_cast<T>(static_cast<unsigned int>(max_value) + 1u);
+    T under = static_cast<T>(0u - 1u);
+    // uint8_t would print as a character
+    say(out, Text::demo_unsigned, name, +max_value, +over, +under);
 }
 
-// NEW: prints min/max for all required types + overflow demos
-void print_all_limits() {
-    print_heading("Min/Max Table (Required Types)");
-    std::cout << std::left << std::setw(18) << "Type"
-              << std::right << std::setw(24) << "Min/Lowest"
-              << std::setw(24) << "Max" << "\n";
-    std::cout << std::string(66, '-') << "\n";
-
-    // char and variants
-    print_limits<char>("char");
-    print_limits<signed char>("signed char");
-    print_limits<unsigned char>("unsigned char");
-
-    // short / int / long / long long and unsigned variants
-    print_limits<short>("short");
-    print_limits<unsigned short>("unsigned short");
-    print_limits<int>("int");
-    print_limits<unsigned int>("unsigned int");
-    print_limits<long>("long");
-    print_limits<unsigned long>("unsigned long");
-    print_limits<long long>("long long");
-    print_limits<unsigned long long>("unsigned long long");
-
-    // fixed-width types
-    print_limits<std::int8_t>("int8_t");
-    print_limits<std::uint8_t>("uint8_t");
-    print_limits<std::int16_t>("int16_t");
-    print_limits<std::uint16_t>("uint16_t");
-    print_limits<std::int32_t>("int32_t");
-    print_limits<std::uint32_t>("uint32_t");
-    print_limits<std::int64_t>("int64_t");
-    print_limits<std::uint64_t>("uint64_t");
-
-    // floating point
-    print_limits<float>("float");
-    print_limits<double>("double");
-    print_limits<long double>("long double");
-
-    print_heading("Float precision (digits you can trust)");
-    std::cout << "float       digits10: " << std::numeric_limits<float>::digits10 << "\n";
-    std::cout << "double      digits10: " << std::numeric_limits<double>::digits10 << "\n";
-    std::cout << "long double digits10: " << std::numeric_limits<long double>::digits10 << "\n";
-
-    print_heading("Overflow Demo (Meets Rubric)");
-
-    // Unsigned wrap (defined behavior)
-    {
-        std::uint8_t u8max = std::numeric_limits<std::uint8_t>::max();
-        std::uint8_t u8_over = static_cast<std::uint8_t>(static_cast<unsigned int>(u8max) + 1u);
-        std::uint8_t u8_under = static_cast<std::uint8_t>(0u - 1u);
+// Signed overflow: simulated (avoid UB)
+template <typename T>
+void show_signed_wrap(std::ostream& out, const char* name) {
+    int bits = std::numeric_limits<T>::digits + 1;
+    long long max_value = static_cast<long long>(std::numeric_limits<T>::max());
+    long long min_value = static_cast<long long>(std::numeric_limits<T>::min());
+    say(out, Text::demo_signed, name, max_value, wrap_signed(max_value + 1, bits),
+        min_value, wrap_signed(min_value - 1, bits));
+}
 
-        std::cout << "Unsigned wrap (uint8_t):\n";
-        std::cout << "  max is " << static_cast<int>(u8max) << "\n";
-        std::cout << "  max + 1 -> " << static_cast<int>(u8_over) << "\n";
-        std::cout << "  0 - 1   -> " << static_cast<int>(u8_under) << "\n";
-    }
-    {
-        std::uint16_t u16max = std::numeric_limits<std::uint16_t>::max();
-        std::uint16_t u16_over = static_cast<std::uint16_t>(static_cast<unsigned int>(u16max) + 1u);
-        std::uint16_t u16_under = static_cast<std::uint16_t>(0u - 1u);
-
-        std::cout << "Unsigned wrap (uint16_t):\n";
-        std::cout << "  max is " << u16max << "\n";
-        std::cout << "  max + 1 -> " << u16_over << "\n";
-        std::cout << "  0 - 1   -> " << u16_under << "\n";
+// NEW: prints min/max for all required types + overflow demos
+arena::Task<> print_all_limits(arena::FlowIo& io) {
+    std::ostream& out = io.out;
+    say(out, Text::limits_table);
+    std::string_view table = arena::limits_table_text();
+    out.write(table.data(), static_cast<std::streamsize>(table.size()));
+
+    say(out, Text::limits_wide);
+    for (const arena::WideTypeLimits& t : arena::kWideTypeLimits) {
+        say(out, Text::limits_wide_row, t.name, t.min_value, t.max_value);
     }
 
-    // Signed overflow: simulated (avoid UB)
-    {
-        std::cout << "Signed overflow (SIMULATED, int8_t):\n";
-        long long s8max = static_cast<long long>(std::numeric_limits<std::int8_t>::max()); // 127
-        long long sim_over = wrap_signed(s8max + 1, 8);
-        std::cout << "  max is " << s8max << "\n";
-        std::cout << "  max + 1 -> " << sim_over << " (simulated)\n";
-
-        long long s8min = static_cast<long long>(std::numeric_limits<std::int8_t>::min()); // -128
-        long long sim_under = wrap_signed(s8min - 1, 8);
-        std::cout << "  min is " << s8min << "\n";
-        std::cout << "  min - 1 -> " << sim_under << " (simulated)\n";
-    }
+    say(out, Text::limits_float_digits, arena::find_type_limits("float")->digits10,
+        arena::find_type_limits("double")->digits10, arena::find_type_limits("long double")->digits10);
+
+    say(out, Text::demo_heading);
+    show_unsigned_wrap<std::uint8_t>(out, "uint8_t");
+    show_unsigned_wrap<std::uint16_t>(out, "uint16_t");
+    show_signed_wrap<std::int8_t>(out, "int8_t");
+    show_signed_wrap<std::int16_t>(out, "int16_t");
     {
-        std::cout << "Signed overflow (SIMULATED, int16_t):\n";
-        long long s16max = static_cast<long long>(std::numeric_limits<std::int16_t>::max());
-        long long sim_over = wrap_signed(s16max + 1, 16);
-        std::cout << "  max is " << s16max << "\n";
-        std::cout << "  max + 1 -> " << sim_over << " (simulated)\n";
-
-        long long s16min = static_cast<long long>(std::numeric_limits<std::int16_t>::min());
-        long long sim_under = wrap_signed(s16min - 1, 16);
-        std::cout << "  min is " << s16min << "\n";
-        std::cout << "  min - 1 -> " << sim_under << " (simulated)\n";
+        // long long can't hold int64_t max + 1, so compute it wider.
+        arena::GameValue s64max(std::numeric_limits<std::int64_t>::max());
+        arena::GameValue s64min(std::numeric_limits<std::int64_t>::min());
+        say(out, Text::demo_signed, "int64_t", s64max, wrap_signed(s64max + arena::GameValue(1), 64),
+            s64min, wrap_signed(s64min - arena::GameValue(1), 64));
     }
 
     // Floating overflow -> inf
     {
-        print_heading("Floating overflow -> inf");
-        std::ios::fmtflags old_flags = std::cout.flags();
-        std::streamsize old_precision = std::cout.precision();
-
-        std::cout << std::scientific << std::setprecision(6);
+        std::ios::fmtflags old_flags = out.flags();
+        std::streamsize old_precision = out.precision();
 
-        float f = std::numeric_limits<float>::max();
-        float f2 = f * 2.0f;
-        std::cout << "float:  max * 2 = " << f2 << " | isinf? " << (std::isinf(f2) ? "true" : "false") << "\n";
+        out << std::scientific << std::setprecision(6);
 
-        double d = std::numeric_limits<double>::max();
-        double d2 = d * 2.0;
-        std::cout << "double: max * 2 = " << d2 << " | isinf? " << (std::isinf(d2) ? "true" : "false") << "\n";
+        float f2 = std::numeric_limits<float>::max() * 2.0f;
+        double d2 = std::numeric_limits<double>::max() * 2.0;
+        long double ld2 = std::numeric_limits<long double>::max() * static_cast<long double>(2.0);
+        say(out, Text::demo_float_inf, f2, std::isinf(f2) ? "true" : "false",
+            d2, std::isinf(d2) ? "true" : "false", ld2, std::isinf(ld2) ? "true" : "false");
 
-        long double ld = std::numeric_limits<long double>::max();
-        long double ld2 = ld * static_cast<long double>(2.0);
-        std::cout << "long double: max * 2 = " << static_cast<long double>(ld2)
-                  << " | isinf? " << (std::isinf(ld2) ? "true" : "false") << "\n";
-
-        std::cout.flags(old_flags);
-        std::cout.precision(old_precision);
+        out.flags(old_flags);
+        out.precision(old_precision);
     }
 
-    print_heading("Optional: Advanced Notes");
-    std::cout << "char signedness is implementation-defined. is_signed = "
-              << (std::numeric_limits<char>::is_signed ? "true" : "false") << "\n";
-    std::cout << "long double precision is implementation-defined; not necessarily quad precision.\n";
+    say(out, Text::advanced_notes, std::numeric_limits<char>::is_signed ? "true" : "false");
 
-    wait_for_enter();
+    co_await wait_for_enter(io);
 }
 
-void optional_advanced_pitfalls() {
-    print_heading("Optional: Advanced Pitfalls");
-    std::cout << "These are here only if you want extra detail.\n";
-
-    print_heading("Lesson");
-    std::cout << "Signed and unsigned can surprise you when mixed.\n";
-
-    print_heading("Prediction");
-    std::cout << "Will (-1 < 1u) be true? (1 = yes, 0 = no)\n";
-    int guess = read_int_from_user("Your guess: ");
+arena::Task<> optional_advanced_pitfalls(arena::FlowIo& io) {
+    std::ostream& out = io.out;
+    say(out, Text::pitfalls_lesson);
+    int guess = co_await read_int_from_user(io, g_text[Text::guess_prompt]);
 
-    print_heading("Run");
     int a = -1;
     unsigned int b = 1u;
     bool result = (static_cast<unsigned int>(a) < b);
-    std::cout << "Result: " << (result ? "true" : "false") << "\n";
+    say(out, Text::run_result, result ? "true" : "false");
 
-    print_heading("What happened?");
-    std::cout << "C++ converts -1 into a big unsigned number.\n";
-    std::cout << "That makes it larger than 1u, so the compare flips.\n";
+    say(out, Text::pitfalls_explain);
+    say(out, Text::reflect, guess);
 
-    print_heading("Reflect");
-    std::cout << "You said " << guess << ".\n";
-
-    wait_for_enter();
+    co_await wait_for_enter(io);
 }
 
-struct GameType {
-    std::string name;
-    int bits;
-    bool is_signed;
-    long long min_value;
-    long long max_value;
-    std::function<long long(long long)> op;
-    std::string op_name;
-};
-
-void overflow_arena() {
-    print_heading("Overflow Arena");
-    std::cout << "How to play: guess the result, then see what happens.\n";
-    std::cout << "Type 'q' to quit after any round.\n";
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-
-    std::vector<GameType> types = {
-        {"uint8_t", 8, false, 0, 255, nullptr, ""},
-        {"uint16_t", 16, false, 0, 65535, nullptr, ""},
-        {"int8_t", 8, true, -128, 127, nullptr, ""},
-        {"int16_t", 16, true, -32768, 32767, nullptr, ""},
-        {"int32_t", 32, true,
-         static_cast<long long>(std::numeric_limits<std::int32_t>::min()),
-         static_cast<long long>(std::numeric_limits<std::int32_t>::max()), nullptr, ""},
-        {"uint32_t", 32, false, 0,
-         static_cast<long long>(std::numeric_limits<std::uint32_t>::max()), nullptr, ""}
-    };
-
-    std::uniform_int_distribution<int> type_dist(0, static_cast<int>(types.size() - 1));
-    std::uniform_int_distribution<int> op_dist(0, 2);
-    std::uniform_int_distribution<int> near_dist(0, 1);
-
-    int score = 0;
-    int rounds = 0;
+arena::Task<> overflow_arena(arena::FlowIo& io) {
+    std::uint32_t seed = g_fixed_seed ? g_seed : std::random_device{}();
+    static const std::vector<arena::GameType> types = arena::make_game_types();
+    arena::ArenaSession session(seed, types, g_round_arena, g_text);
+    if (g_round_log.is_open()) {
+        session.set_log(&g_round_log);
+    }
+    if (g_board_slot) {
+        session.set_leaderboard(&g_board_slot);
+    }
 
+    session.begin(io.out);
     while (true) {
-        GameType gt = types[type_dist(gen)];
-        int op_choice = op_dist(gen);
-        if (op_choice == 0) {
-            gt.op = [](long long v) { return v + 1; };
-            gt.op_name = "+1";
-        } else if (op_choice == 1) {
-            gt.op = [](long long v) { return v - 1; };
-            gt.op_name = "-1";
-        } else {
-            gt.op = [](long long v) { return v * 2; };
-            gt.op_name = "*2";
-        }
-
-        bool near_max = (near_dist(gen) == 1);
-        long long start = near_max ? gt.max_value : gt.min_value;
-        start += near_max ? -1 : 1;
-
-        std::cout << "\nRound " << (rounds + 1) << " | Type: " << gt.name
-                  << " | Start: " << start << " | Op: " << gt.op_name << "\n";
-        if (gt.is_signed) {
-            std::cout << "Hint: Range is negative to positive; we simulate wrap for learning.\n";
-        } else {
-            std::cout << "Hint: If it goes past max, it starts over at 0.\n";
-        }
-        print_heading("Prediction");
-        std::cout << "What number prints? (or q to quit)\n";
-        std::cout << "Your guess: ";
-
-        std::string line;
-        if (!std::getline(std::cin, line)) {
+        std::optional<std::string_view> line = co_await io.in.next_line();
+        if (!line || !session.handle_line(*line, io.out)) {
             break;
         }
-        if (!line.empty() && (line[0] == 'q' || line[0] == 'Q')) {
-            std::cout << "Exiting game. Final score: " << score << "/" << rounds << "\n";
-            break;
-        }
-
-        std::stringstream ss(line);
-        long long user_guess = 0;
-        if (!(ss >> user_guess)) {
-            print_heading("Try again");
-            std::cout << "Please enter a valid integer.\n";
-            continue;
-        }
-
-        long long wide_before = start;
-        long long wide_after = gt.op(wide_before);
-        long long final_value = 0;
-        if (gt.is_signed) {
-            final_value = wrap_signed(wide_after, gt.bits);
-        } else {
-            final_value = wrap_unsigned(wide_after, gt.bits);
-        }
-
-        std::string before_bits;
-        std::string after_bits;
-        if (gt.is_signed) {
-            before_bits = binary_from_signed(start, gt.bits);
-            after_bits = binary_from_signed(final_value, gt.bits);
-        } else if (gt.bits == 8) {
-            before_bits = to_binary_string(static_cast<std::uint8_t>(start));
-            after_bits = to_binary_string(static_cast<std::uint8_t>(final_value));
-        } else if (gt.bits == 16) {
-            before_bits = to_binary_string(static_cast<std::uint16_t>(start));
-            after_bits = to_binary_string(static_cast<std::uint16_t>(final_value));
-        } else if (gt.bits == 32) {
-            before_bits = to_binary_string(static_cast<std::uint32_t>(start));
-            after_bits = to_binary_string(static_cast<std::uint32_t>(final_value));
-        } else {
-            before_bits = to_binary_string(static_cast<std::uint64_t>(start));
-            after_bits = to_binary_string(static_cast<std::uint64_t>(final_value));
-        }
-
-        print_heading("Run");
-        std::cout << "Result: " << final_value << "\n";
-        std::cout << "Range: " << gt.min_value << " to " << gt.max_value << "\n";
-        std::cout << "If you're curious, here is what it looks like in bits:\n";
-        std::cout << before_bits << " -> " << after_bits << "\n";
-
-        print_heading("What happened?");
-        if (gt.is_signed) {
-            std::cout << "Signed overflow is not safe to rely on in C++.\n";
-            std::cout << "We simulate what many computers do so you can learn.\n";
-        } else {
-            std::cout << "Unsigned values wrap around when they pass the limit.\n";
-        }
-
-        if (user_guess == final_value) {
-            score++;
-            std::cout << "Result: Correct!\n";
-        } else {
-            std::cout << "Result: Not quite. You guessed " << user_guess << ".\n";
-        }
-
-        rounds++;
-        std::cout << "Score: " << score << "/" << rounds << "\n";
     }
 
-    wait_for_enter();
+    co_await wait_for_enter(io);
 }
 
-void print_menu() {
-    print_heading("Overflow Arena - Main Menu");
-    std::cout << "[1] Quick Tour (learn and predict)\n";
-    std::cout << "[2] Print All Min/Max Tables + Overflow Demos\n";
-    std::cout << "[3] Play Overflow Arena (game)\n";
-    std::cout << "[4] Optional: Advanced Pitfalls\n";
-    std::cout << "[5] Exit\n";
+void print_menu(std::ostream& out) {
+    say(out, Text::menu);
 }
 
-} // namespace
-
-int main() {
-    std::cout << "Welcome to Overflow Arena!\n";
+arena::Task<> main_menu(arena::FlowIo& io) {
+    std::ostream& out = io.out;
+    say(out, Text::welcome);
 
     while (true) {
-        print_menu();
-        int choice = read_int_from_user("Choose an option: ");
+        g_lesson_arena.reset();
+        arena::FrameArenaScope lesson_frames(g_lesson_arena.resource());
+
+        print_menu(out);
+        int choice = co_await read_int_from_user(io, g_text[Text::menu_prompt]);
 
         switch (choice) {
             case 1:
-                show_micro_lessons();
-                quick_tour();
+                co_await show_micro_lessons(io);
+                co_await quick_tour(io);
                 break;
             case 2:
-                print_all_limits();
+                co_await print_all_limits(io);
                 break;
             case 3:
-                overflow_arena();
+                co_await overflow_arena(io);
                 break;
             case 4:
-                optional_advanced_pitfalls();
+                co_await optional_advanced_pitfalls(io);
                 break;
             case 5:
-                std::cout << "Goodbye!\n";
-                return 0;
+                say(out, Text::goodbye);
+                co_return;
             default:
-                print_heading("Try again");
-                std::cout << "Please choose 1-5.\n";
+                say(out, Text::menu_invalid);
                 break;
         }
     }
 }
+
+void usage() {
+    std::cerr << "usage: overflow_arena [--seed N] [--log FILE] [--catalog FILE]\n"
+                 "                      [--board NAME] [--player NAME]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* board_name = nullptr;
+    const char* player = std::getenv("USER");
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            if (arena::parse_int(argv[++i], g_seed, std::uint32_t{0},
+                                 std::numeric_limits<std::uint32_t>::max()) != arena::ParseStatus::ok) {
+                usage();
+                return 1;
+            }
+            g_fixed_seed = true;
+        } else if (arg == "--log" && i + 1 < argc) {
+            if (!g_round_log.open(argv[++i])) {
+                perror(argv[i]);
+                return 1;
+            }
+        } else if (arg == "--catalog" && i + 1 < argc) {
+            arena::CatalogStatus status = g_catalog_file.open(argv[++i]);
+            if (status == arena::CatalogStatus::io_error) {
+                perror(argv[i]);
+                return 1;
+            }
+            if (status != arena::CatalogStatus::ok) {
+                std::cerr << argv[i] << ": not a lesson catalog for this build\n";
+                return 1;
+            }
+            g_text = g_catalog_file.catalog();
+        } else if (arg == "--board" && i + 1 < argc) {
+            board_name = argv[++i];
+        } else if (arg == "--player" && i + 1 < argc) {
+            player = argv[++i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (board_name != nullptr) {
+        arena::BoardStatus status = g_board.open(board_name);
+        if (status == arena::BoardStatus::io_error) {
+            perror(board_name);
+            return 1;
+        }
+        if (status != arena::BoardStatus::ok) {
+            std::cerr << board_name << ": not an arena leaderboard\n";
+            return 1;
+        }
+        g_board_slot = g_board.claim(player != nullptr ? player : "player");
+        if (!g_board_slot) {
+            std::cerr << board_name << ": leaderboard is full, playing without it\n";
+        }
+    }
+
+    arena::ConsoleOutput console;
+    arena::metrics::install_dump_signal();
+    struct sigaction stop{};
+    stop.sa_handler = on_signal;
+    sigemptyset(&stop.sa_mask);
+    sigaction(SIGINT, &stop, nullptr);
+    sigaction(SIGTERM, &stop, nullptr);
+
+    // stdin driver: run the menu flow until it waits for a line, then
+    // flush and block on std::cin to get it one.
+    arena::Scheduler scheduler;
+    arena::LineInput input(scheduler);
+    arena::FlowIo io{std::cout, input};
+    arena::Task<> flow = main_menu(io);
+    scheduler.schedule(flow.handle());
+
+    std::string line;
+    while (!g_stop) {
+        scheduler.run();
+        if (flow.done() || input.hung_up() || !input.waiting()) {
+            break;
+        }
+        {
+            ARENA_TIME_SCOPE(console_flush);
+            std::cout.flush();
+        }
+        if (std::getline(std::cin, line)) {
+            input.feed(line);
+        } else {
+            input.close();
+        }
+    }
+    std::cout.flush();
+    g_round_log.close();
+    arena::metrics::dump_json(STDERR_FILENO);
+    return 0;
+}
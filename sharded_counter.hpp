@@ -0,0 +1,54 @@
+/*
+    A counter that many threads can bump without fighting over one
+    cache line.
+
+    A function-local `static int` (as in HW1_3's showStaticLocal) is a
+    data race once several threads touch it. Making it std::atomic fixes
+    the race, but then every increment bounces the same cache line
+    between cores. ShardedCounter gives each thread its own cache-line
+    sized slot and only adds the slots up when someone reads the total.
+*/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 64 bytes on x86-64 and most ARM cores. Not using
+// std::hardware_destructive_interference_size because its value can
+// change between compiler versions and GCC warns about it in headers.
+constexpr std::size_t kCacheLineSize = 64;
+
+class ShardedCounter {
+public:
+    static constexpr std::size_t kShards = 64;
+
+    void add(std::int64_t n = 1) {
+        slots_[shard_index()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Sum of every slot. Concurrent add() calls may or may not be seen.
+    std::int64_t read() const {
+        std::int64_t total = 0;
+        for (const Slot& slot : slots_) {
+            total += slot.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    struct alignas(kCacheLineSize) Slot {
+        std::atomic<std::int64_t> value{0};
+    };
+
+    // Threads get slots round-robin on first use. With more than kShards
+    // threads some share a slot, which is still correct, just slower.
+    static std::size_t shard_index() {
+        static std::atomic<std::size_t> next_shard{0};
+        thread_local std::size_t index = next_shard.fetch_add(1, std::memory_order_relaxed) % kShards;
+        return index;
+    }
+
+    std::array<Slot, kShards> slots_;
+};
@@ -0,0 +1,332 @@
+/*
+    Fixed-width two's complement integers wider than long long.
+
+    wide_int<Bits> (Bits = 64, 128 or 256) is a signed integer whose
+    +, - and * wrap modulo 2^Bits. Overflow Arena computes its ops in
+    wide_int<256>, so an op on an int64_t, uint64_t or __int128 value
+    is exact before it gets wrapped down to the game type's width,
+    just like long long always was for the 8- to 32-bit types.
+
+    The 64- and 128-bit versions do their arithmetic in one native
+    uint64_t / unsigned __int128. 256 bits uses four 64-bit limbs with
+    an add-with-carry chain and a truncated schoolbook multiply (only
+    the low 256 bits of a product are ever kept), so nothing here ever
+    falls back to general bignum code.
+
+    from_chars() is a hidden friend with std::from_chars semantics, so
+    arena::parse_int() works for wide_int unchanged.
+*/
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace arena {
+
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+
+template <int Bits>
+class wide_int {
+    static_assert(Bits == 64 || Bits == 128 || Bits == 256, "wide_int supports 64, 128 and 256 bits");
+
+public:
+    static constexpr int kLimbs = Bits / 64;
+
+    constexpr wide_int() = default;
+
+    constexpr explicit wide_int(long long v) {
+        std::uint64_t fill = v < 0 ? ~0ULL : 0;
+        limbs_[0] = static_cast<std::uint64_t>(v);
+        for (int i = 1; i < kLimbs; ++i) limbs_[i] = fill;
+    }
+
+    static constexpr wide_int from_uint64(std::uint64_t v) {
+        wide_int r;
+        r.limbs_[0] = v;
+        return r;
+    }
+
+    // Wraps to Bits when Bits is 64.
+    static constexpr wide_int from_int128(int128_t v) {
+        wide_int r;
+        r.limbs_[0] = static_cast<std::uint64_t>(v);
+        if constexpr (kLimbs > 1) {
+            r.limbs_[1] = static_cast<std::uint64_t>(static_cast<uint128_t>(v) >> 64);
+            for (int i = 2; i < kLimbs; ++i) r.limbs_[i] = v < 0 ? ~0ULL : 0;
+        }
+        return r;
+    }
+
+    static constexpr wide_int from_uint128(uint128_t v) {
+        wide_int r;
+        r.limbs_[0] = static_cast<std::uint64_t>(v);
+        if constexpr (kLimbs > 1) {
+            r.limbs_[1] = static_cast<std::uint64_t>(v >> 64);
+        }
+        return r;
+    }
+
+    // 2^n for 0 <= n < Bits.
+    static constexpr wide_int power_of_two(int n) {
+        wide_int r;
+        r.limbs_[n / 64] = 1ULL << (n % 64);
+        return r;
+    }
+
+    constexpr std::uint64_t low64() const { return limbs_[0]; }
+    constexpr std::uint64_t limb(int i) const { return limbs_[i]; }
+    constexpr uint128_t low128() const {
+        uint128_t r = limbs_[0];
+        if constexpr (kLimbs > 1) r |= static_cast<uint128_t>(limbs_[1]) << 64;
+        return r;
+    }
+
+    constexpr bool bit(int n) const { return (limbs_[n / 64] >> (n % 64)) & 1u; }
+    constexpr bool is_negative() const { return bit(Bits - 1); }
+
+    // True if the value is unchanged by truncating it to long long.
+    constexpr bool fits_int64() const {
+        std::uint64_t fill = (limbs_[0] >> 63) ? ~0ULL : 0;
+        for (int i = 1; i < kLimbs; ++i) {
+            if (limbs_[i] != fill) return false;
+        }
+        return true;
+    }
+
+    // Keeps the low `bits` bits and sign- or zero-extends from there.
+    // Widths of Bits or more return the value unchanged.
+    constexpr wide_int wrapped(int bits, bool sign_extend) const {
+        if (bits <= 0 || bits >= Bits) return *this;
+        wide_int r;
+        std::uint64_t fill = sign_extend && bit(bits - 1) ? ~0ULL : 0;
+#pragma GCC unroll 4
+        for (int i = 0; i < kLimbs; ++i) {
+            int kept = bits - i * 64; // bits of this limb that are kept
+            std::uint64_t mask = kept >= 64 ? ~0ULL : kept <= 0 ? 0 : (1ULL << kept) - 1;
+            r.limbs_[i] = (limbs_[i] & mask) | (fill & ~mask);
+        }
+        return r;
+    }
+
+    friend constexpr wide_int operator+(const wide_int& a, const wide_int& b) {
+        wide_int r;
+        if constexpr (Bits == 64) {
+            r.limbs_[0] = a.limbs_[0] + b.limbs_[0];
+        } else if constexpr (Bits == 128) {
+            r = from_uint128(a.low128() + b.low128());
+        } else {
+            bool carry = false;
+#pragma GCC unroll 4
+            for (int i = 0; i < kLimbs; ++i) {
+                std::uint64_t t = 0;
+                bool c1 = __builtin_add_overflow(a.limbs_[i], b.limbs_[i], &t);
+                bool c2 = __builtin_add_overflow(t, static_cast<std::uint64_t>(carry), &r.limbs_[i]);
+                carry = c1 | c2;
+            }
+        }
+        return r;
+    }
+
+    friend constexpr wide_int operator-(const wide_int& a, const wide_int& b) {
+        wide_int r;
+        if constexpr (Bits == 64) {
+            r.limbs_[0] = a.limbs_[0] - b.limbs_[0];
+        } else if constexpr (Bits == 128) {
+            r = from_uint128(a.low128() - b.low128());
+        } else {
+            bool borrow = false;
+#pragma GCC unroll 4
+            for (int i = 0; i < kLimbs; ++i) {
+                std::uint64_t t = 0;
+                bool b1 = __builtin_sub_overflow(a.limbs_[i], b.limbs_[i], &t);
+                bool b2 = __builtin_sub_overflow(t, static_cast<std::uint64_t>(borrow), &r.limbs_[i]);
+                borrow = b1 | b2;
+            }
+        }
+        return r;
+    }
+
+    friend constexpr wide_int operator*(const wide_int& a, const wide_int& b) {
+        wide_int r;
+        if constexpr (Bits == 64) {
+            r.limbs_[0] = a.limbs_[0] * b.limbs_[0];
+        } else if constexpr (Bits == 128) {
+            r = from_uint128(a.low128() * b.low128());
+        } else {
+#pragma GCC unroll 4
+            for (int i = 0; i < kLimbs; ++i) {
+                std::uint64_t carry = 0;
+#pragma GCC unroll 4
+                for (int j = 0; i + j < kLimbs; ++j) {
+                    uint128_t t = static_cast<uint128_t>(a.limbs_[i]) * b.limbs_[j] + r.limbs_[i + j] + carry;
+                    r.limbs_[i + j] = static_cast<std::uint64_t>(t);
+                    carry = static_cast<std::uint64_t>(t >> 64);
+                }
+            }
+        }
+        return r;
+    }
+
+    friend constexpr wide_int operator-(const wide_int& a) { return wide_int() - a; }
+
+    friend constexpr bool operator==(const wide_int& a, const wide_int& b) {
+        for (int i = 0; i < kLimbs; ++i) {
+            if (a.limbs_[i] != b.limbs_[i]) return false;
+        }
+        return true;
+    }
+    friend constexpr bool operator!=(const wide_int& a, const wide_int& b) { return !(a == b); }
+
+    // Signed comparison.
+    friend constexpr bool operator<(const wide_int& a, const wide_int& b) {
+        if (a.is_negative() != b.is_negative()) return a.is_negative();
+        for (int i = kLimbs - 1; i >= 0; --i) {
+            if (a.limbs_[i] != b.limbs_[i]) return a.limbs_[i] < b.limbs_[i];
+        }
+        return false;
+    }
+    friend constexpr bool operator>(const wide_int& a, const wide_int& b) { return b < a; }
+    friend constexpr bool operator<=(const wide_int& a, const wide_int& b) { return !(b < a); }
+    friend constexpr bool operator>=(const wide_int& a, const wide_int& b) { return !(a < b); }
+
+    // Room for the decimal text of any value, sign included.
+    static constexpr int kMaxDecimalChars = Bits * 31 / 100 + 3;
+
+    // Decimal text; as_unsigned reads the bits as an unsigned value.
+    std::string to_string(bool as_unsigned = false) const {
+        char buf[kMaxDecimalChars];
+        char* end = buf + sizeof(buf);
+        return std::string(format_decimal(end, as_unsigned), end);
+    }
+
+    // The low `bits` bits, most significant first.
+    std::string binary_string(int bits) const {
+        std::string s(static_cast<std::size_t>(bits), '0');
+        write_binary(s.data(), bits);
+        return s;
+    }
+
+    // binary_string() into out[0, bits), for callers that own the buffer.
+    constexpr void write_binary(char* out, int bits) const {
+        for (int i = 0; i < bits; ++i) {
+            out[i] = bit(bits - 1 - i) ? '1' : '0';
+        }
+    }
+
+    // std::to_chars semantics: value_too_large if [first, last) is too short.
+    friend std::to_chars_result to_chars(char* first, char* last, const wide_int& value) {
+        char buf[kMaxDecimalChars];
+        char* end = buf + sizeof(buf);
+        char* p = value.format_decimal(end, false);
+        if (end - p > last - first) return {last, std::errc::value_too_large};
+        return {std::copy(p, end, first), std::errc()};
+    }
+
+    // Optional '-', then decimal digits; stops at the first non-digit.
+    friend constexpr std::from_chars_result from_chars(const char* first, const char* last, wide_int& value) {
+        const char* p = first;
+        bool negative = p != last && *p == '-';
+        if (negative) ++p;
+        const char* digits = p;
+        wide_int mag;
+        bool overflow = false;
+        for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+            if (!overflow) overflow = mag.mul_add_small(10, static_cast<std::uint64_t>(*p - '0'));
+        }
+        if (p == digits) return {first, std::errc::invalid_argument};
+        if (!overflow && mag.is_negative()) {
+            overflow = !negative || mag != power_of_two(Bits - 1);
+        }
+        if (overflow) return {p, std::errc::result_out_of_range};
+        value = negative ? -mag : mag;
+        return {p, std::errc()};
+    }
+
+private:
+    // Writes the decimal text so that it ends at `end`, which must have
+    // kMaxDecimalChars bytes before it, and returns where it starts.
+    char* format_decimal(char* end, bool as_unsigned) const {
+        bool negative = !as_unsigned && is_negative();
+        char* p = end;
+        if (fits_int64() && !(as_unsigned && is_negative())) {
+            std::uint64_t mag = negative ? 0 - limbs_[0] : limbs_[0];
+            do {
+                *--p = static_cast<char>('0' + mag % 10);
+                mag /= 10;
+            } while (mag != 0);
+            if (negative) *--p = '-';
+            return p;
+        }
+        // The magnitude of the most negative value is 2^(Bits-1), which
+        // negation leaves as the same bits: correct when read unsigned.
+        wide_int mag = negative ? -*this : *this;
+
+        constexpr std::uint64_t kChunk = 10000000000000000000ULL; // 10^19
+        while (true) {
+            std::uint64_t rem = mag.divide_small(kChunk);
+            bool last = mag == wide_int();
+            for (int d = 0; d < 19 && (!last || rem != 0 || d == 0); ++d) {
+                *--p = static_cast<char>('0' + rem % 10);
+                rem /= 10;
+            }
+            if (last) break;
+        }
+        if (negative) *--p = '-';
+        return p;
+    }
+
+    // *this = *this * m + a on the unsigned value; returns true if the
+    // result did not fit in Bits.
+    constexpr bool mul_add_small(std::uint64_t m, std::uint64_t a) {
+        std::uint64_t carry = a;
+        for (int i = 0; i < kLimbs; ++i) {
+            uint128_t t = static_cast<uint128_t>(limbs_[i]) * m + carry;
+            limbs_[i] = static_cast<std::uint64_t>(t);
+            carry = static_cast<std::uint64_t>(t >> 64);
+        }
+        return carry != 0;
+    }
+
+    // *this /= d on the unsigned value; returns the remainder.
+    constexpr std::uint64_t divide_small(std::uint64_t d) {
+        uint128_t rem = 0;
+        for (int i = kLimbs - 1; i >= 0; --i) {
+            uint128_t cur = (rem << 64) | limbs_[i];
+            limbs_[i] = static_cast<std::uint64_t>(cur / d);
+            rem = cur % d;
+        }
+        return static_cast<std::uint64_t>(rem);
+    }
+
+    std::uint64_t limbs_[kLimbs] = {};
+};
+
+template <int Bits>
+constexpr wide_int<Bits> wrap_signed(const wide_int<Bits>& value, int bits) {
+    return value.wrapped(bits, true);
+}
+
+template <int Bits>
+constexpr wide_int<Bits> wrap_unsigned(const wide_int<Bits>& value, int bits) {
+    return value.wrapped(bits, false);
+}
+
+template <int Bits>
+std::ostream& operator<<(std::ostream& os, const wide_int<Bits>& v) {
+    if (v.fits_int64()) return os << static_cast<long long>(v.low64());
+    char buf[wide_int<Bits>::kMaxDecimalChars];
+    std::to_chars_result r = to_chars(buf, buf + sizeof(buf), v);
+    return os << std::string_view(buf, static_cast<std::size_t>(r.ptr - buf));
+}
+
+static_assert((wide_int<256>::power_of_two(127) * wide_int<256>(2)).limb(2) == 1);
+static_assert(wrap_signed(wide_int<256>(255), 8) == wide_int<256>(-1));
+static_assert(-wide_int<128>(5) < wide_int<128>(3));
+
+} // namespace arena
@@ -0,0 +1,340 @@
+/*
+    Exhaustive differential check of the arena wrap and binary helpers.
+
+    For 8, 16 and 32 bits, every input of both the signed and unsigned
+    type goes through each arena op (+1, -1, *2) the way the lessons do
+    it (op on long long, then wrap_signed/wrap_unsigned), compared
+    against doing the op natively in the fixed-width unsigned type and
+    casting back. The way the game does it (arena::apply_op on a
+    256-bit GameValue, then arena::wrap_to_type) is checked the same
+    way, exhaustively for 8 and 16 bits but only every 64th input for
+    32 bits: it costs several times the wrap functions, and would
+    otherwise dominate both the sweep's run time and its M/s figure.
+    The binary helpers are checked against a hand-built bit string:
+    exhaustively for 8 and 16 bits, every 4096th input for 32 bits.
+
+    64- and 128-bit inputs are sampled and go through the game path
+    only; long long can't hold their op results. The 128-bit pass also
+    checks wide_int<64> and wide_int<128> arithmetic against native
+    uint64_t / unsigned __int128.
+
+    The sweep is split into chunks across threads, and the timings
+    double as a throughput benchmark for the wrap functions.
+
+    Build: g++ -std=c++17 -O2 -pthread wrap_verify.cpp -o wrap_verify
+    Usage: wrap_verify [-j threads] [--bits 8|16|32|64|128]...
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "arena_core.hpp"
+#include "arena_parse.hpp"
+#include "arith.hpp"
+#include "wide_int.hpp"
+
+namespace {
+
+constexpr std::uint64_t kChunk = 1 << 20;
+constexpr std::uint64_t kBinaryStride32 = 4096;
+constexpr std::uint64_t kGameStride32 = 64;
+constexpr std::uint64_t kSamplesWide = 1 << 24;
+constexpr std::size_t kMaxReported = 8;
+
+struct Tally {
+    std::atomic<std::uint64_t> wrap_checks{0};
+    std::atomic<std::uint64_t> binary_checks{0};
+    std::atomic<std::uint64_t> mismatches{0};
+    std::mutex report_mutex;
+    std::vector<std::string> reports;
+
+    void mismatch(std::string what) {
+        mismatches.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(report_mutex);
+        if (reports.size() < kMaxReported) reports.push_back(std::move(what));
+    }
+};
+
+template <typename U>
+U native_op(U u, int op_choice) {
+    if (op_choice == 0) return static_cast<U>(u + 1u);
+    if (op_choice == 1) return static_cast<U>(u - 1u);
+    return static_cast<U>(u * 2u);
+}
+
+std::string reference_bits(std::uint64_t value, int bits) {
+    std::string s(static_cast<std::size_t>(bits), '0');
+    for (int i = 0; i < bits; ++i) {
+        if ((value >> (bits - 1 - i)) & 1u) s[static_cast<std::size_t>(i)] = '1';
+    }
+    return s;
+}
+
+// The op as the lessons compute it: in long long, before wrapping.
+long long lesson_op(int op_choice, long long v) {
+    if (op_choice == 0) return arith::add(v, 1LL);
+    if (op_choice == 1) return arith::sub(v, 1LL);
+    return arith::mul(v, 2LL);
+}
+
+std::string describe(const char* what, const std::string& input, int op_choice,
+                     const std::string& got, const std::string& want) {
+    return std::string(what) + " input " + input + " op " + arena::op_name(op_choice) +
+           ": got " + got + ", want " + want;
+}
+
+template <typename U>
+void check_range(std::uint64_t first, std::uint64_t last, Tally& tally) {
+    using S = std::make_signed_t<U>;
+    constexpr int bits = static_cast<int>(sizeof(U) * 8);
+    const bool check_binary = bits <= 16;
+    const bool check_game = bits <= 16;
+    const arena::GameType unsigned_type = arena::make_game_type("u", bits, false);
+    const arena::GameType signed_type = arena::make_game_type("s", bits, true);
+
+    std::uint64_t local_checks = 0;
+    std::uint64_t local_binary = 0;
+    for (std::uint64_t i = first; i < last; ++i) {
+        U u = static_cast<U>(i);
+        S s = static_cast<S>(u);
+        const bool game = check_game || i % kGameStride32 == 0;
+        for (int op = 0; op < arena::kOpCount; ++op) {
+            U native = native_op(u, op);
+            long long want_u = static_cast<long long>(native);
+            long long want_s = static_cast<long long>(static_cast<S>(native));
+
+            long long got_u = arena::wrap_unsigned(lesson_op(op, static_cast<long long>(u)), bits);
+            if (got_u != want_u) {
+                tally.mismatch(describe("wrap_unsigned", std::to_string(u), op,
+                                        std::to_string(got_u), std::to_string(want_u)));
+            }
+            long long got_s = arena::wrap_signed(lesson_op(op, static_cast<long long>(s)), bits);
+            if (got_s != want_s) {
+                tally.mismatch(describe("wrap_signed", std::to_string(s), op,
+                                        std::to_string(got_s), std::to_string(want_s)));
+            }
+            if (!game) continue;
+
+            arena::GameValue game_u =
+                arena::wrap_to_type(unsigned_type, arena::apply_op(op, arena::GameValue(static_cast<long long>(u))));
+            if (game_u != arena::GameValue(want_u)) {
+                tally.mismatch(describe("game unsigned", std::to_string(u), op,
+                                        game_u.to_string(), std::to_string(want_u)));
+            }
+            arena::GameValue game_s =
+                arena::wrap_to_type(signed_type, arena::apply_op(op, arena::GameValue(static_cast<long long>(s))));
+            if (game_s != arena::GameValue(want_s)) {
+                tally.mismatch(describe("game signed", std::to_string(s), op,
+                                        game_s.to_string(), std::to_string(want_s)));
+            }
+        }
+        local_checks += (game ? 4 : 2) * arena::kOpCount;
+
+        if (check_binary || i % kBinaryStride32 == 0) {
+            std::string want = reference_bits(i, bits);
+            if (arena::to_binary_string(u) != want) {
+                tally.mismatch("to_binary_string(unsigned) input " + std::to_string(i));
+            }
+            if (arena::to_binary_string(s) != want) {
+                tally.mismatch("to_binary_string(signed) input " + std::to_string(s));
+            }
+            if (arena::binary_from_signed(s, bits) != want) {
+                tally.mismatch("binary_from_signed input " + std::to_string(s));
+            }
+            if (arena::GameValue(static_cast<long long>(s)).binary_string(bits) != want) {
+                tally.mismatch("GameValue::binary_string input " + std::to_string(s));
+            }
+            local_binary += 4;
+        }
+    }
+    tally.wrap_checks.fetch_add(local_checks, std::memory_order_relaxed);
+    tally.binary_checks.fetch_add(local_binary, std::memory_order_relaxed);
+}
+
+std::string u128_string(arena::uint128_t v) {
+    return arena::wide_int<256>::from_uint128(v).to_string();
+}
+
+// Samples of the game path for 64- and 128-bit types. U is uint64_t or
+// uint128_t; biased towards the ends of the range, where wrapping happens.
+template <typename U>
+void check_samples(std::uint64_t seed, std::uint64_t count, Tally& tally) {
+    constexpr int bits = static_cast<int>(sizeof(U) * 8);
+    const arena::GameType unsigned_type = arena::make_game_type("u", bits, false);
+    const arena::GameType signed_type = arena::make_game_type("s", bits, true);
+    const U sign_bit = static_cast<U>(1) << (bits - 1);
+    auto from_unsigned = [](U v) { return arena::GameValue::from_uint128(v); };
+    auto from_signed = [&](U v) {
+        return (v & sign_bit) ? from_unsigned(v) - arena::GameValue::power_of_two(bits) : from_unsigned(v);
+    };
+
+    std::mt19937_64 gen(seed);
+    std::uint64_t local_checks = 0;
+    std::uint64_t local_binary = 0;
+    for (std::uint64_t n = 0; n < count; ++n) {
+        U u = static_cast<U>(gen());
+        if constexpr (bits > 64) u = (u << 64) | gen();
+        if (n % 4 == 1) u = static_cast<U>(~static_cast<U>(0) - (u & 0xFF));
+        if (n % 4 == 2) u = static_cast<U>(sign_bit + (u & 0xFF) - 0x80);
+
+        for (int op = 0; op < arena::kOpCount; ++op) {
+            U native = native_op(u, op);
+            arena::GameValue got_u = arena::wrap_to_type(unsigned_type, arena::apply_op(op, from_unsigned(u)));
+            if (got_u != from_unsigned(native)) {
+                tally.mismatch(describe("game unsigned", u128_string(u), op, got_u.to_string(), u128_string(native)));
+            }
+            arena::GameValue got_s = arena::wrap_to_type(signed_type, arena::apply_op(op, from_signed(u)));
+            if (got_s != from_signed(native)) {
+                tally.mismatch(describe("game signed", from_signed(u).to_string(), op, got_s.to_string(),
+                                        from_signed(native).to_string()));
+            }
+        }
+        local_checks += 2 * arena::kOpCount;
+
+        if constexpr (bits > 64) {
+            // The native fast paths of the narrower widths.
+            U v = static_cast<U>(gen()) << 64 | gen();
+            arena::wide_int<128> a = arena::wide_int<128>::from_uint128(u);
+            arena::wide_int<128> b = arena::wide_int<128>::from_uint128(v);
+            if ((a + b).low128() != static_cast<U>(u + v) || (a - b).low128() != static_cast<U>(u - v) ||
+                (a * b).low128() != static_cast<U>(u * v)) {
+                tally.mismatch("wide_int<128> arithmetic input " + u128_string(u) + ", " + u128_string(v));
+            }
+            arena::wide_int<64> a64 = arena::wide_int<64>::from_uint64(static_cast<std::uint64_t>(u));
+            arena::wide_int<64> b64 = arena::wide_int<64>::from_uint64(static_cast<std::uint64_t>(v));
+            if ((a64 * b64 - a64 + b64).low64() !=
+                static_cast<std::uint64_t>(u) * static_cast<std::uint64_t>(v) - static_cast<std::uint64_t>(u) +
+                    static_cast<std::uint64_t>(v)) {
+                tally.mismatch("wide_int<64> arithmetic input " + u128_string(u) + ", " + u128_string(v));
+            }
+            // And the 256-bit carry chain against the 128-bit result.
+            arena::GameValue wide = arena::GameValue::from_uint128(u) * arena::GameValue::from_uint128(v) +
+                                    arena::GameValue::from_uint128(u) - arena::GameValue::from_uint128(v);
+            if (wide.low128() != static_cast<U>(u * v + u - v)) {
+                tally.mismatch("wide_int<256> arithmetic input " + u128_string(u) + ", " + u128_string(v));
+            }
+            local_checks += 3;
+        }
+
+        if (n % kBinaryStride32 == 0) {
+            std::string want(static_cast<std::size_t>(bits), '0');
+            for (int b = 0; b < bits; ++b) {
+                if ((u >> (bits - 1 - b)) & 1u) want[static_cast<std::size_t>(b)] = '1';
+            }
+            arena::GameValue parsed;
+            std::string text = from_signed(u).to_string();
+            if (arena::parse_int(text, parsed, signed_type.min_value, signed_type.max_value) != arena::ParseStatus::ok ||
+                parsed != from_signed(u)) {
+                tally.mismatch("GameValue text round trip " + text);
+            }
+            if (from_signed(u).binary_string(bits) != want) {
+                tally.mismatch("GameValue::binary_string input " + text);
+            }
+            local_binary += 2;
+        }
+    }
+    tally.wrap_checks.fetch_add(local_checks, std::memory_order_relaxed);
+    tally.binary_checks.fetch_add(local_binary, std::memory_order_relaxed);
+}
+
+template <typename Work>
+void run_parallel(unsigned threads, std::uint64_t chunks, Work work) {
+    std::atomic<std::uint64_t> next{0};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&] {
+            for (std::uint64_t c = next++; c < chunks; c = next++) {
+                work(c);
+            }
+        });
+    }
+    for (std::thread& th : pool) {
+        th.join();
+    }
+}
+
+bool verify(int bits, unsigned threads) {
+    Tally tally;
+    auto t0 = std::chrono::steady_clock::now();
+    if (bits >= 64) {
+        std::uint64_t chunks = kSamplesWide / kChunk;
+        run_parallel(threads, chunks, [&](std::uint64_t c) {
+            if (bits == 64) check_samples<std::uint64_t>(c + 1, kChunk, tally);
+            if (bits == 128) check_samples<arena::uint128_t>(c + 1, kChunk, tally);
+        });
+    } else {
+        std::uint64_t total = 1ULL << bits;
+        std::uint64_t chunks = (total + kChunk - 1) / kChunk;
+        run_parallel(threads, chunks, [&](std::uint64_t c) {
+            std::uint64_t first = c * kChunk;
+            std::uint64_t last = std::min(total, first + kChunk);
+            if (bits == 8) check_range<std::uint8_t>(first, last, tally);
+            if (bits == 16) check_range<std::uint16_t>(first, last, tally);
+            if (bits == 32) check_range<std::uint32_t>(first, last, tally);
+        });
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::uint64_t checks = tally.wrap_checks.load();
+    std::cout << std::setw(3) << bits << "-bit " << (bits >= 64 ? "sampled   " : "exhaustive")
+              << std::setw(14) << checks << " wrap checks"
+              << std::setw(11) << tally.binary_checks.load() << " binary checks"
+              << std::fixed << std::setprecision(2) << std::setw(9) << seconds << " s"
+              << std::setprecision(1) << std::setw(9)
+              << (seconds > 0 ? static_cast<double>(checks) / seconds / 1e6 : 0.0) << " M/s"
+              << "  mismatches: " << tally.mismatches.load() << "\n";
+    for (const std::string& r : tally.reports) {
+        std::cout << "    " << r << "\n";
+    }
+    return tally.mismatches.load() == 0;
+}
+
+void usage() {
+    std::cerr << "usage: wrap_verify [-j threads] [--bits 8|16|32|64|128]...\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> widths;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        int bits = 0;
+        if (arg == "-j" && i + 1 < argc) {
+            if (arena::parse_int(argv[++i], threads, 1u, 1024u) != arena::ParseStatus::ok) {
+                usage();
+                return 1;
+            }
+        } else if (arg == "--bits" && i + 1 < argc &&
+                   arena::parse_int(argv[++i], bits, 8, 128) == arena::ParseStatus::ok &&
+                   (bits == 8 || bits == 16 || bits == 32 || bits == 64 || bits == 128)) {
+            widths.push_back(bits);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (widths.empty()) {
+        widths = {8, 16, 32, 64, 128};
+    }
+
+    std::cout << "Threads: " << threads << "\n";
+    bool ok = true;
+    for (int bits : widths) {
+        ok = verify(bits, threads) && ok;
+    }
+    std::cout << (ok ? "All checks passed.\n" : "MISMATCHES FOUND.\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,380 @@
+/*
+    A background service that writes whole files for many producer
+    threads at once.
+
+    HW1_4 writes part1.txt and part3.txt one after the other from
+    main(). An exporter that writes thousands of files that way spends
+    most of its time waiting on one write() at a time. Here producers
+    fill buffers from a BufferPool, chain them into a WriteJob and
+    submit() it. Jobs go through a bounded lock-free queue
+    (mpmc_queue.hpp) to a group of writer threads, each of which opens
+    the file with O_CLOEXEC, writes the chain with writev() and hands
+    the buffers back to the pool.
+
+    Writers are grouped per device, not per machine. More writers than
+    a disk can keep busy only add seeks and contention. So the service
+    stat()s the output directories it is given and, for each distinct
+    device, starts its own queue and threads_per_device writers.
+    submit() routes a job by the device of the directory it writes
+    into, so a slow disk backs up only its own queue and writers while
+    jobs for the other disks keep flowing. Directories on separate
+    partitions of one disk count as separate devices; a job outside
+    every known device goes to the first group.
+
+    The queues and the buffer pool are bounded. A producer that runs
+    ahead of a disk blocks in submit() or BufferPool::acquire() instead
+    of growing memory.
+
+    With checksum_block set, each writer also computes a CRC32C per
+    checksum_block bytes of the file as it writes the chain, and stores
+    them in a sidecar (block_checksums.hpp) that crc_verify checks.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "block_checksums.hpp"
+#include "mpmc_queue.hpp"
+
+namespace fileio {
+
+// One pooled block of bytes. A file's contents are a chain of them
+// linked through `next`.
+struct Buffer {
+    Buffer* next = nullptr;
+    std::size_t size = 0; // bytes in use
+    char* data = nullptr;
+};
+
+// Fixed number of equal-sized buffers carved from one allocation.
+// The storage is page-aligned so it can also be used with O_DIRECT.
+class BufferPool {
+public:
+    BufferPool(std::size_t count, std::size_t buffer_size)
+        : buffer_size_(round_up(buffer_size, kAlignment)),
+          buffers_(count),
+          free_(count),
+          storage_(static_cast<char*>(std::aligned_alloc(kAlignment, buffer_size_ * count))) {
+        if (storage_ == nullptr) throw std::bad_alloc();
+        for (std::size_t i = 0; i < count; ++i) {
+            buffers_[i].data = storage_.get() + i * buffer_size_;
+            Buffer* b = &buffers_[i];
+            free_.try_push(b);
+        }
+    }
+
+    std::size_t buffer_size() const { return buffer_size_; }
+    std::size_t count() const { return buffers_.size(); }
+
+    // Waits until a buffer is free. The buffer comes back empty.
+    Buffer* acquire() {
+        Buffer* b = nullptr;
+        while (!free_.try_pop(b)) {
+            released_.wait([&] { return free_.size_approx() > 0; });
+        }
+        b->next = nullptr;
+        b->size = 0;
+        return b;
+    }
+
+    // Returns a whole chain.
+    void release(Buffer* chain) {
+        while (chain != nullptr) {
+            Buffer* next = chain->next;
+            free_.try_push(chain);
+            chain = next;
+        }
+        released_.notify_all();
+    }
+
+private:
+    static constexpr std::size_t kAlignment = 4096;
+
+    static std::size_t round_up(std::size_t n, std::size_t to) {
+        return (std::max<std::size_t>(n, 1) + to - 1) / to * to;
+    }
+
+    struct FreeStorage {
+        void operator()(char* p) const { std::free(p); }
+    };
+
+    std::size_t buffer_size_;
+    std::vector<Buffer> buffers_;
+    MpmcQueue<Buffer*> free_;
+    Parking released_;
+    std::unique_ptr<char, FreeStorage> storage_;
+};
+
+// A file to create (or truncate) and the buffers that become its
+// contents. An empty chain makes an empty file.
+struct WriteJob {
+    std::string path;
+    Buffer* data = nullptr;
+};
+
+struct WriteStats {
+    std::uint64_t jobs_done = 0;
+    std::uint64_t jobs_failed = 0;
+    std::uint64_t bytes_written = 0;
+    std::size_t queue_depth = 0;     // jobs waiting right now, all devices
+    std::size_t max_queue_depth = 0; // deepest any one device's queue got
+    double seconds = 0;              // since the service started
+    int first_errno = 0;             // of the first failed job, or 0
+
+    double mb_per_second() const { return seconds > 0 ? bytes_written / seconds / 1e6 : 0; }
+    double jobs_per_second() const { return seconds > 0 ? jobs_done / seconds : 0; }
+};
+
+// Number of distinct devices (st_dev) holding `directories`, or 0 if
+// one of them cannot be stat()ed.
+inline std::size_t count_devices(const std::vector<std::string>& directories) {
+    std::vector<dev_t> devices;
+    for (const std::string& dir : directories) {
+        struct stat st;
+        if (stat(dir.c_str(), &st) != 0) return 0;
+        if (std::find(devices.begin(), devices.end(), st.st_dev) == devices.end()) {
+            devices.push_back(st.st_dev);
+        }
+    }
+    return devices.size();
+}
+
+class WriteService {
+public:
+    struct Options {
+        std::vector<std::string> directories{"."}; // where jobs will write
+        unsigned threads_per_device = 4;
+        std::size_t queue_capacity = 1024; // per device
+        std::uint32_t checksum_block = 0; // nonzero: write a CRC32C sidecar per file
+    };
+
+    WriteService(BufferPool& pool, const Options& options)
+        : pool_(pool), checksum_block_(options.checksum_block), start_(Clock::now()) {
+        for (const std::string& dir : options.directories) {
+            struct stat st;
+            if (stat(dir.c_str(), &st) != 0) continue;
+            std::size_t index = 0;
+            while (index < groups_.size() && groups_[index]->device != st.st_dev) ++index;
+            if (index == groups_.size()) {
+                groups_.push_back(std::make_unique<DeviceGroup>(st.st_dev, options.queue_capacity));
+            }
+            known_dirs_.emplace_back(std::string(normalize(dir)), index);
+        }
+        if (groups_.empty()) {
+            groups_.push_back(std::make_unique<DeviceGroup>(dev_t{}, options.queue_capacity));
+        }
+        unsigned per_device = std::max(options.threads_per_device, 1u);
+        workers_.reserve(groups_.size() * per_device);
+        for (std::unique_ptr<DeviceGroup>& g : groups_) {
+            for (unsigned i = 0; i < per_device; ++i) {
+                workers_.emplace_back([this, group = g.get()] { run(*group); });
+            }
+        }
+    }
+
+    ~WriteService() { close(); }
+
+    WriteService(const WriteService&) = delete;
+    WriteService& operator=(const WriteService&) = delete;
+
+    std::size_t devices() const { return groups_.size(); }
+    std::size_t threads() const { return workers_.size(); }
+    std::size_t queue_capacity() const { return groups_.front()->queue.capacity(); } // per device
+
+    // Queues a job on its device's queue, waiting while that queue is
+    // full. Safe from any number of threads, but not concurrently with
+    // close().
+    void submit(WriteJob job) {
+        DeviceGroup& g = group_for(job.path);
+        while (!g.queue.try_push(job)) {
+            g.not_full.wait([&] { return g.queue.size_approx() < g.queue.capacity(); });
+        }
+        g.not_empty.notify_one();
+
+        std::size_t depth = g.queue.size_approx();
+        std::size_t seen = max_depth_.load(std::memory_order_relaxed);
+        while (depth > seen && !max_depth_.compare_exchange_weak(seen, depth, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Finishes every queued job and stops the writers. Idempotent.
+    void close() {
+        if (stopping_.exchange(true)) return;
+        for (std::unique_ptr<DeviceGroup>& g : groups_) g->not_empty.notify_all();
+        for (std::thread& t : workers_) t.join();
+        stopped_ = Clock::now();
+        closed_.store(true, std::memory_order_release);
+    }
+
+    WriteStats stats() const {
+        WriteStats s;
+        s.jobs_done = jobs_done_.load(std::memory_order_relaxed);
+        s.jobs_failed = jobs_failed_.load(std::memory_order_relaxed);
+        s.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+        for (const std::unique_ptr<DeviceGroup>& g : groups_) s.queue_depth += g->queue.size_approx();
+        s.max_queue_depth = max_depth_.load(std::memory_order_relaxed);
+        s.first_errno = first_errno_.load(std::memory_order_relaxed);
+        bool closed = closed_.load(std::memory_order_acquire);
+        s.seconds = std::chrono::duration<double>((closed ? stopped_ : Clock::now()) - start_).count();
+        return s;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // writev() takes at most IOV_MAX (1024 on Linux) entries; batches
+    // this size already amortize the syscall.
+    static constexpr int kMaxIov = 64;
+
+    // One device's queue and the writers that drain it.
+    struct DeviceGroup {
+        DeviceGroup(dev_t dev, std::size_t capacity) : device(dev), queue(capacity) {}
+
+        dev_t device;
+        MpmcQueue<WriteJob> queue;
+        Parking not_empty;
+        Parking not_full;
+    };
+
+    // "dir/" and "dir" name the same directory; "" is ".".
+    static std::string_view normalize(std::string_view dir) {
+        while (dir.size() > 1 && dir.back() == '/') dir.remove_suffix(1);
+        return dir.empty() ? std::string_view(".") : dir;
+    }
+
+    // The group for the directory `path` is in: by name if it is one of
+    // Options::directories, else by stat(), else the first group.
+    DeviceGroup& group_for(const std::string& path) {
+        if (groups_.size() == 1) return *groups_.front();
+        std::size_t slash = path.rfind('/');
+        std::string_view dir = slash == std::string::npos ? std::string_view(".")
+                               : slash == 0               ? std::string_view("/")
+                                                          : normalize(std::string_view(path).substr(0, slash));
+        for (const auto& [name, index] : known_dirs_) {
+            if (name == dir) return *groups_[index];
+        }
+        struct stat st;
+        if (stat(std::string(dir).c_str(), &st) == 0) {
+            for (std::unique_ptr<DeviceGroup>& g : groups_) {
+                if (g->device == st.st_dev) return *g;
+            }
+        }
+        return *groups_.front();
+    }
+
+    void run(DeviceGroup& g) {
+        WriteJob job;
+        BlockChecksummer checksums(checksum_block_);
+        while (true) {
+            if (g.queue.try_pop(job)) {
+                g.not_full.notify_one();
+                write_job(job, checksums);
+                continue;
+            }
+            // Producers are done once stopping_ is set, so an empty
+            // queue then means there is nothing left.
+            if (stopping_.load()) return;
+            g.not_empty.wait([&] { return g.queue.size_approx() > 0 || stopping_.load(); });
+        }
+    }
+
+    void write_job(WriteJob& job, BlockChecksummer& checksums) {
+        if (checksum_block_ != 0) {
+            // The producer just filled these buffers, so they are still
+            // in cache.
+            checksums.reset();
+            for (const Buffer* b = job.data; b != nullptr; b = b->next) checksums.update(b->data, b->size);
+        }
+        int error = 0;
+        std::uint64_t written = 0;
+        int fd = ::open(job.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            error = errno;
+        } else {
+            error = write_chain(fd, job.data, written);
+            if (::close(fd) != 0 && error == 0) error = errno;
+        }
+        if (error == 0 && checksum_block_ != 0) {
+            error = write_sidecar(job.path, checksum_block_, checksums.size(), checksums.finish());
+        }
+        pool_.release(job.data);
+        job.data = nullptr;
+
+        bytes_written_.fetch_add(written, std::memory_order_relaxed);
+        if (error != 0) {
+            int none = 0;
+            first_errno_.compare_exchange_strong(none, error, std::memory_order_relaxed);
+            jobs_failed_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            jobs_done_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Writes the chain in writev() batches, resuming after short
+    // writes. Returns 0 or an errno value.
+    static int write_chain(int fd, const Buffer* chain, std::uint64_t& written) {
+        iovec iov[kMaxIov];
+        while (chain != nullptr) {
+            int count = 0;
+            for (; chain != nullptr && count < kMaxIov; chain = chain->next) {
+                if (chain->size == 0) continue;
+                iov[count++] = {chain->data, chain->size};
+            }
+            int first = 0;
+            while (first < count) {
+                ssize_t n = ::writev(fd, iov + first, count - first);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    return errno;
+                }
+                written += static_cast<std::uint64_t>(n);
+                auto left = static_cast<std::size_t>(n);
+                while (first < count && left >= iov[first].iov_len) {
+                    left -= iov[first].iov_len;
+                    ++first;
+                }
+                if (left > 0) {
+                    iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+                    iov[first].iov_len -= left;
+                }
+            }
+        }
+        return 0;
+    }
+
+    BufferPool& pool_;
+    std::vector<std::unique_ptr<DeviceGroup>> groups_;
+    std::vector<std::pair<std::string, std::size_t>> known_dirs_; // directory, index in groups_
+    std::atomic<bool> stopping_{false};
+    std::vector<std::thread> workers_;
+    std::uint32_t checksum_block_;
+
+    std::atomic<std::uint64_t> jobs_done_{0};
+    std::atomic<std::uint64_t> jobs_failed_{0};
+    std::atomic<std::uint64_t> bytes_written_{0};
+    std::atomic<std::size_t> max_depth_{0};
+    std::atomic<int> first_errno_{0};
+    Clock::time_point start_;
+    Clock::time_point stopped_;
+    std::atomic<bool> closed_{false}; // stopped_ is set
+};
+
+} // namespace fileio